@@ -21,5 +21,7 @@ WinMain(HINSTANCE Instance,
         sgl_win32_process_msgs();
         sgl_default_render(&default_main_window);
     }   
+    sgl_free_default_state();
+    sgl_window_destroy(&default_main_window);
     return 0;
 }
\ No newline at end of file
@@ -48,6 +48,7 @@
 //  1)
 //      - You can either directly set the values of the SGLWindow struct
 //      - Or call sgl_platform_window_setup with your desired values
+//      - Optionally call sgl_window_framebuffer_setup to pick colour/depth/stencil bits, MSAA and sRGB
 //  2)
 //      - Call sgl_window
 // 
@@ -75,6 +76,19 @@
 // API  : API reference can be found further down.
 //        In the following sections (search for) :
 //          [Win32 Create an OpenGL ready window]  -> Win32 Window Creation API
+//          [Debug Output]                         -> KHR_debug message capture and counters
+//          [Thread Pool]                          -> Tiny parallel-for used by the heavier modules
+//          [Frustum Culling]                      -> SIMD frustum culling, LOD selection and draw lists
+//          [Occlusion Culling]                    -> Occlusion queries and conditional rendering
+//          [Binary Meshes]                        -> Memory mapped mesh files, zero-copy upload, .obj converter
+//          [Vertex Quantization]                  -> Half float / snorm / 10:10:10:2 vertex packing
+//          [Sprite Batching]                      -> Atlased 2D quads, one draw per atlas per layer
+//          [Text]                                 -> Glyph cache, cached runs, one instanced draw per frame
+//          [Render Targets]                       -> Framebuffer + colour/depth textures
+//          [Render Graph]                         -> Pass culling, transient target pooling and sharing
+//          [Tiled Rendering]                      -> Images bigger than a framebuffer, streamed to disk
+//          [Compute]                              -> Compute programs, storage buffers, automatic barriers
+//          [GPU Memory]                           -> Live/peak GPU memory per category, leak report at teardown
 //          [DECLARE NEW GL FUNCTION]              -> Declare new GL function that you need
 //          [LOAD NEW GL FUNCTION]                 -> Load new GL function that you need (must declare first)
 //          [DEFAULT EXAMPLE]                      -> Ready to run examples.
@@ -105,14 +119,33 @@
 // [INTERNAL] Types --------------
 #include <stdint.h>
 //Unsigned
+typedef uint64_t uint64;
 typedef uint32_t uint32;
 typedef uint16_t uint16;
 typedef uint8_t  uint8;
 //Signed
 typedef int32_t int32;
+typedef int16_t int16;
 //Bool
 typedef int32 bool32;
 
+// [INTERNAL] SIMD
+// SSE2 is always there on x64, AVX2 paths are only compiled in when the compiler targets it (/arch:AVX2).
+// Define SGL_NO_SIMD before including the header to get the scalar paths only.
+#if !defined(SGL_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SGL_SSE2 1
+#include <emmintrin.h>
+#endif
+#if !defined(SGL_NO_SIMD) && defined(__AVX2__)
+#define SGL_AVX2 1
+#include <immintrin.h>
+#endif
+//F16C comes with every AVX2 CPU, MSVC doesn't have a define for it.
+#if !defined(SGL_NO_SIMD) && (defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__)))
+#define SGL_F16C 1
+#include <immintrin.h>
+#endif
+
 // [INTERNAL] Static Declarations
 #define internal        static
 #define global_variable static
@@ -125,6 +158,19 @@ typedef int32 bool32;
 #define InvalidDefaultCase default: {InvalidCodePath;} break
 #define SGL_Assert(Expression) if(!(Expression)) {*(int *)0 = 0;}
 
+// [INTERNAL] Atomics - all of them are full barriers, they return the value *before* the operation
+// except SGL_AtomicIncrement which returns the incremented value.
+#ifdef _WIN32
+typedef volatile LONG sgl_atomic32;
+#define SGL_AtomicIncrement(dest)                          InterlockedIncrement((dest))
+#define SGL_AtomicAdd(dest, value)                         InterlockedExchangeAdd((dest), (LONG)(value))
+#define SGL_AtomicExchange(dest, value)                    InterlockedExchange((dest), (LONG)(value))
+#define SGL_AtomicCompareExchange(dest, value, expected)   InterlockedCompareExchange((dest), (LONG)(value), (LONG)(expected))
+#else
+    //@TODO: Other OS
+   #error No other OS defined!
+#endif //_WIN32
+
 #ifdef _WIN32
 //[INTERNAL] Function Pointers Typedefs
 #define WIN32_WINDOW_CALLBACK(name) LRESULT CALLBACK name(HWND Window,UINT Message,WPARAM WParam,LPARAM LParam)
@@ -136,7 +182,11 @@ typedef WIN32_WINDOW_CALLBACK(win32_window_callback);
 //@NOTE: gl.h can be found in almost all win32 systems while the other headers are not usually present.
 typedef char			GLchar;
 typedef ptrdiff_t		GLsizeiptr;
+typedef ptrdiff_t		GLintptr;
 typedef uint64_t    	GLuint64;
+typedef struct __GLsync *GLsync;
+typedef void (APIENTRY *GLDEBUGPROC)(GLenum source, GLenum type, GLuint id, GLenum severity,
+                                     GLsizei length, const GLchar *message, const void *user_param);
 
 //Enums in glcorearb.h from https://www.khronos.org/registry/OpenGL/index_gl.php#headers
     #define GL_TEXTURE0								0x84C0
@@ -144,6 +194,7 @@ typedef uint64_t    	GLuint64;
     #define GL_TEXTURE_RECTANGLE					0x84F5
     #define GL_RGBA_INTEGER							0x8D99
     #define GL_HALF_FLOAT							0x140B
+    #define GL_INT_2_10_10_10_REV                   0x8D9F
     #define GL_RGBA16UI								0x8D76
     #define GL_RGBA16F								0x881A
     #define GL_VERTEX_SHADER						0x8B31
@@ -151,6 +202,15 @@ typedef uint64_t    	GLuint64;
     #define GL_ARRAY_BUFFER							0x8892
     #define GL_ELEMENT_ARRAY_BUFFER					0x8893
     #define GL_STATIC_DRAW							0x88E4
+    #define GL_STREAM_DRAW							0x88E0
+    #define GL_DYNAMIC_DRAW							0x88E8
+    #define GL_CLAMP_TO_EDGE						0x812F
+    #define GL_R8									0x8229
+    #define GL_UNPACK_ROW_LENGTH					0x0CF2
+    #define GL_BLEND_DST_RGB						0x80C8
+    #define GL_BLEND_SRC_RGB						0x80C9
+    #define GL_BLEND_DST_ALPHA						0x80CA
+    #define GL_BLEND_SRC_ALPHA						0x80CB
     #define GL_WRITE_ONLY							0x88B9
     #define GL_QUERY_RESULT							0x8866
     #define GL_TIME_ELAPSED							0x88BF
@@ -160,6 +220,87 @@ typedef uint64_t    	GLuint64;
     #define GL_INFO_LOG_LENGTH                      0x8B84
     #define GL_GEOMETRY_SHADER                      0x8DD9
     #define GL_LINK_STATUS                          0x8B82
+    #define GL_MULTISAMPLE                          0x809D
+    #define GL_DEBUG_OUTPUT                         0x92E0
+    #define GL_DEBUG_OUTPUT_SYNCHRONOUS             0x8242
+    #define GL_DEBUG_SOURCE_API                     0x8246
+    #define GL_DEBUG_TYPE_ERROR                     0x824C
+    #define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR       0x824D
+    #define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR        0x824E
+    #define GL_DEBUG_TYPE_PORTABILITY               0x824F
+    #define GL_DEBUG_TYPE_PERFORMANCE               0x8250
+    #define GL_DEBUG_TYPE_OTHER                     0x8251
+    #define GL_DEBUG_SEVERITY_HIGH                  0x9146
+    #define GL_DEBUG_SEVERITY_MEDIUM                0x9147
+    #define GL_DEBUG_SEVERITY_LOW                   0x9148
+    #define GL_DEBUG_SEVERITY_NOTIFICATION          0x826B
+    #define GL_DONT_CARE                            0x1100
+    #define GL_CONTEXT_FLAGS                        0x821E
+    #define GL_CONTEXT_FLAG_DEBUG_BIT               0x00000002
+    #define GL_BUFFER                               0x82E0
+    #define GL_SHADER                               0x82E1
+    #define GL_PROGRAM                              0x82E2
+    #define GL_VERTEX_ARRAY                         0x8074
+    #define GL_QUERY                                0x82E3
+    #define GL_ANY_SAMPLES_PASSED                   0x8C2F
+    #define GL_CURRENT_PROGRAM                      0x8B8D
+    #define GL_VERTEX_ARRAY_BINDING                 0x85B5
+    #define GL_ANY_SAMPLES_PASSED_CONSERVATIVE      0x8D6A
+    #define GL_QUERY_RESULT_AVAILABLE               0x8867
+    #define GL_QUERY_WAIT                           0x8E13
+    #define GL_QUERY_NO_WAIT                        0x8E14
+    #define GL_QUERY_BY_REGION_WAIT                 0x8E15
+    #define GL_MAJOR_VERSION                        0x821B
+    #define GL_MINOR_VERSION                        0x821C
+    #define GL_MAP_READ_BIT                         0x0001
+    #define GL_MAP_WRITE_BIT                        0x0002
+    #define GL_MAP_INVALIDATE_RANGE_BIT             0x0004
+    #define GL_MAP_INVALIDATE_BUFFER_BIT            0x0008
+    #define GL_MAP_FLUSH_EXPLICIT_BIT               0x0010
+    #define GL_MAP_UNSYNCHRONIZED_BIT               0x0020
+    #define GL_FRAMEBUFFER                          0x8D40
+    #define GL_RENDERBUFFER                         0x8D41
+    #define GL_READ_FRAMEBUFFER                     0x8CA8
+    #define GL_DRAW_FRAMEBUFFER                     0x8CA9
+    #define GL_FRAMEBUFFER_COMPLETE                 0x8CD5
+    #define GL_COLOR_ATTACHMENT0                    0x8CE0
+    #define GL_DEPTH_ATTACHMENT                     0x8D00
+    #define GL_DEPTH_STENCIL_ATTACHMENT             0x821A
+    #define GL_MAX_RENDERBUFFER_SIZE                0x84E8
+    #define GL_RGBA32F                              0x8814
+    #define GL_RG16F                                0x822F
+    #define GL_R16F                                 0x822D
+    #define GL_R32F                                 0x822E
+    #define GL_RG8                                  0x822B
+    #define GL_R11F_G11F_B10F                       0x8C3A
+    #define GL_SRGB8_ALPHA8                         0x8C43
+    #define GL_DEPTH_COMPONENT24                    0x81A6
+    #define GL_DEPTH_COMPONENT32F                   0x8CAC
+    #define GL_DEPTH24_STENCIL8                     0x88F0
+    #define GL_DEPTH_STENCIL                        0x84F9
+    #define GL_UNSIGNED_INT_24_8                    0x84FA
+    #define GL_DEBUG_SOURCE_APPLICATION             0x824A
+    #define GL_PIXEL_PACK_BUFFER                    0x88EB
+    #define GL_STREAM_READ                          0x88E1
+    #define GL_SYNC_GPU_COMMANDS_COMPLETE           0x9117
+    #define GL_SYNC_FLUSH_COMMANDS_BIT              0x00000001
+    #define GL_ALREADY_SIGNALED                     0x911A
+    #define GL_TIMEOUT_EXPIRED                      0x911B
+    #define GL_CONDITION_SATISFIED                  0x911C
+    #define GL_WAIT_FAILED                          0x911D
+    #define GL_COMPUTE_SHADER                       0x91B9
+    #define GL_COMPUTE_WORK_GROUP_SIZE              0x8267
+    #define GL_SHADER_STORAGE_BUFFER                0x90D2
+    #define GL_DISPATCH_INDIRECT_BUFFER             0x90EE
+    #define GL_COPY_READ_BUFFER                     0x8F36
+    #define GL_COPY_WRITE_BUFFER                    0x8F37
+    #define GL_DYNAMIC_COPY                         0x88EA
+    #define GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT      0x00000001
+    #define GL_ELEMENT_ARRAY_BARRIER_BIT            0x00000002
+    #define GL_UNIFORM_BARRIER_BIT                  0x00000004
+    #define GL_COMMAND_BARRIER_BIT                  0x00000040
+    #define GL_BUFFER_UPDATE_BARRIER_BIT            0x00000200
+    #define GL_SHADER_STORAGE_BARRIER_BIT           0x00002000
 
 
 
@@ -171,6 +312,8 @@ typedef uint64_t    	GLuint64;
     #define WGL_CONTEXT_MINOR_VERSION_ARB			0x2092
     #define WGL_CONTEXT_PROFILE_MASK_ARB			0x9126
     #define WGL_CONTEXT_CORE_PROFILE_BIT_ARB		0x00000001
+    #define WGL_CONTEXT_FLAGS_ARB                   0x2094
+    #define WGL_CONTEXT_DEBUG_BIT_ARB               0x00000001
     #define WGL_DRAW_TO_WINDOW_ARB					0x2001
     #define WGL_ACCELERATION_ARB					0x2003
     #define WGL_SUPPORT_OPENGL_ARB					0x2010
@@ -183,6 +326,8 @@ typedef uint64_t    	GLuint64;
     #define WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB		0x20A9
     #define WGL_DEPTH_BITS_ARB                      0x2022
     #define WGL_STENCIL_BITS_ARB                    0x2023
+    #define WGL_SAMPLE_BUFFERS_ARB                  0x2041
+    #define WGL_SAMPLES_ARB                         0x2042
 
 #endif //_WIN32
 
@@ -192,6 +337,20 @@ typedef uint64_t    	GLuint64;
 //
 //=============================================================================
 
+//Describes the framebuffer (pixel format) we want our window to have.
+//Bits are minimums, the driver might give us more. Setting depth_bits/stencil_bits to 0 asks for
+//a framebuffer with no depth/stencil at all, which is what 2D and headless workloads want.
+struct SGLFramebufferConfig {
+    bool32 initialized;
+    int32 color_bits;   //RGB bits, not counting alpha.
+    int32 alpha_bits;
+    int32 depth_bits;
+    int32 stencil_bits;
+    int32 samples;      //MSAA sample count, 0 = no multisampling.
+    bool32 srgb;        //sRGB capable framebuffer, GL_FRAMEBUFFER_SRGB gets enabled for us.
+    bool32 double_buffer;
+};
+
 struct SGLWindow {
     //platorm independent part
     bool32 initialized;
@@ -202,6 +361,14 @@ struct SGLWindow {
     bool32 fullscreen;
     bool32 running;
 
+    //Ask for a debug context and route KHR_debug output through sgl_debug_* (see [Debug Output])
+    bool32 debug_context;
+
+    //framebuffer - the config we ask for (see sgl_window_framebuffer_setup)
+    //framebuffer_chosen - the config the driver actually gave us, filled in by sgl_win32_window_ogl_setup
+    SGLFramebufferConfig framebuffer;
+    SGLFramebufferConfig framebuffer_chosen;
+
     union 
     {
         //Win32
@@ -225,6 +392,22 @@ struct SGLWindow {
 void  sgl_win32_window_setup(SGLWindow* window,char* title = "SimpleOGL Window", int32 width = 800, int32 height = 600, bool32 full_screen = 0);
 
 
+// The default framebuffer : 24 bit colour, 8 bit alpha, 24 bit depth, 8 bit stencil, double buffered, no MSAA.
+SGLFramebufferConfig sgl_framebuffer_config_default();
+
+// The leanest framebuffer that still gives correct output for 2D and headless work :
+// 24 bit colour, no alpha, no depth, no stencil, no MSAA.
+// This saves a lot of memory bandwidth (no depth/stencil clears, reads or writes).
+SGLFramebufferConfig sgl_framebuffer_config_lean();
+
+// Sets the framebuffer config that sgl_win32_window_ogl_setup will ask the driver for.
+// Must be called before sgl_win32_window_ogl_setup (or sgl_window).
+// If this is never called we get sgl_framebuffer_config_default().
+//
+// window - pointer to the SGLWindow struct
+// config - the desired framebuffer config
+void sgl_window_framebuffer_setup(SGLWindow* window, SGLFramebufferConfig config);
+
 // This function can be called without setting any paramaters of the SGLWindow struct,
 // if this is the case and the SGLWindow is not initialized we will get a default window.
 // In Win32 OS the default can be seen as the default params in the sgl_win32_window_setup function.
@@ -246,6 +429,10 @@ void sgl_win32_window_create(SGLWindow* window,HINSTANCE instance,win32_window_c
 //For example if we specify major = 3 and minor = 0 we will be requesting a Opengl version 3.0 context.
 //If we don't specify major and minor then we will get the lastest supported version in our system.
 //
+//The pixel format is negotiated with wglChoosePixelFormatARB using window->framebuffer, when that is not
+//available we fall back to ChoosePixelFormat. Either way window->framebuffer_chosen is filled in with
+//what we actually got.
+//
 //window        - pointer to SGLWindow struct
 //major_version - desired major version of OpenGL
 //minor_version - desired minor version of OpenGL
@@ -260,118 +447,6254 @@ void sgl_window(SGLWindow* window,HINSTANCE instance,win32_window_callback* wind
 //window - pointer to SGLWindow struct 
 void sgl_win32_window_toggle_fullscreen(SGLWindow* window);
 
-//END API -------------------------------
+//Tears the window down : prints the GPU memory leak report and resets the tracking (see [GPU Memory]),
+//deletes the GL context and destroys the window. Free your GL objects before calling it.
+void sgl_window_destroy(SGLWindow* window);
 
-//===============================================================================  
-// [IMPLEMENTATION]
-//=============================================================================== 
-#ifdef SIMPLE_OGL_IMPLEMENTATION
+//=============================================================================
+// API - [Debug Output]
+//
+// Opt-in KHR_debug capture. Set SGLWindow.debug_context = true before sgl_window (or call
+// sgl_debug_output_setup yourself on a debug context) and the driver's messages get counted and
+// deduplicated, GL_DEBUG_TYPE_PERFORMANCE ones (buffer migrations, shader recompiles, implicit syncs...)
+// are pushed into a lock-free ring that you drain whenever it suits you.
+//
+// The GL callback never blocks or prints, when the ring is full messages are dropped and counted.
+// A message is only pushed once per frame, repeats just bump the counters.
+//=============================================================================
+
+//Override these before including the header if you need more room.
+#ifndef SGL_DEBUG_RING_SIZE
+#define SGL_DEBUG_RING_SIZE     256     //Must be a power of 2
+#endif
+#ifndef SGL_DEBUG_MESSAGE_MAX
+#define SGL_DEBUG_MESSAGE_MAX   256
+#endif
+
+struct SGLDebugMessage {
+    uint32 frame;
+    GLenum source;
+    GLenum type;
+    GLenum severity;
+    GLuint id;
+    char   text[SGL_DEBUG_MESSAGE_MAX];
+};
+
+struct SGLDebugStats {
+    uint32 frame;
+    uint32 total_messages;
+    uint32 unique_messages;
+    uint32 error_messages;
+    uint32 performance_messages;
+    uint32 deprecated_messages;
+    uint32 undefined_messages;
+    uint32 portability_messages;
+    uint32 other_messages;
+    uint32 high_severity_messages;
+    uint32 ring_pushed;
+    uint32 ring_dropped;
+};
+
+//Installs the debug callback on the current context. Returns false if KHR_debug is not available.
+//synchronous - if true the driver calls us on the GL thread right away (GL_DEBUG_OUTPUT_SYNCHRONOUS),
+//              slower but the callstack points at the offending call.
+bool32 sgl_debug_output_setup(bool32 synchronous = false);
+
+//Call once per frame (after SwapBuffers), messages are tagged with the current frame number.
+//Returns the new frame number.
+uint32 sgl_debug_frame_advance();
 
+//Pops the oldest performance message in the ring. Returns false if the ring is empty.
+//Only one thread should be draining the ring.
+bool32 sgl_debug_pop_message(SGLDebugMessage* message);
+
+//Copies the summary counters.
+void sgl_debug_get_stats(SGLDebugStats* stats);
+
+//Names a GL object so driver messages refer to it by name. Does nothing without KHR_debug.
+//identifier - GL_BUFFER, GL_PROGRAM, GL_TEXTURE, GL_VERTEX_ARRAY...
+void sgl_debug_label(GLenum identifier, GLuint name, const char* label);
+
+//=============================================================================
+// API - [Thread Pool]
 //
-//[OpenGL Functions] ---------------------
+// A very small parallel-for. sgl_thread_pool_run hands out job indices [0, job_count) to the
+// worker threads AND the calling thread, and returns when all of them are done.
+//=============================================================================
 
-//@TODO: Explain this bit more
-//Macro for Declaring OpenGL Function Pointers
-#define DECLARE_GL_FUNC_PTR(return_type, func_name, params) typedef return_type func_name##_func_signature params; \
-                                                            func_name##_func_signature *func_name = nullptr; 
+#ifndef SGL_MAX_THREADS
+#define SGL_MAX_THREADS 64
+#endif
+
+typedef void sgl_job_func(void* data, uint32 job_index);
+
+struct SGLThreadPool {
+    int32 thread_count;
+    HANDLE threads[SGL_MAX_THREADS];
+    HANDLE work_semaphore;
+    HANDLE done_event;
+
+    sgl_job_func* func;
+    void* data;
+    sgl_atomic32 job_count;
+    sgl_atomic32 generation;    //Run counter, also packed into the top bits of next_job
+    sgl_atomic32 next_job;
+    sgl_atomic32 jobs_done;
+    sgl_atomic32 quit;
+};
 
-#ifdef _WIN32
-//Macro for getting the adress of the given OpenGL function and checking we have a valid address (not null).
-#define GET_GL_FUNC_SAFE(name) name = (name##_func_signature *)wglGetProcAddress(#name); \
-                               SGL_Assert(name);
-#else
-    //@TODO: Other OS
-   #error No other OS defined!
-#endif //_WIN32
+//thread_count - number of worker threads, 0 = one per core minus the calling thread.
+bool32 sgl_thread_pool_create(SGLThreadPool* pool, int32 thread_count = 0);
+
+//Calls func(data, index) for every index in [0, job_count), blocks until they are all done.
+//job_count must stay below SGL_THREAD_POOL_MAX_JOBS.
+#define SGL_THREAD_POOL_MAX_JOBS (1 << 19)
+void sgl_thread_pool_run(SGLThreadPool* pool, uint32 job_count, sgl_job_func* func, void* data);
+
+void sgl_thread_pool_destroy(SGLThreadPool* pool);
+
+//=============================================================================
+// API - [Frustum Culling]
+//
+// Keeps object bounds in structure-of-arrays layout, culls them against the frustum planes four
+// (SSE2) or eight (AVX2) at a time, picks a LOD per visible object from its projected size and writes
+// a compacted SGLDrawList that goes straight into glMultiDrawElements.
+//
+//  SGLCullObjects objects; sgl_cull_objects_create(&objects, 100000);
+//  SGLDrawList draws;      sgl_draw_list_create(&draws, 100000);
+//  ... sgl_cull_object_add(&objects, ...) for every object ...
+//
+//  Every frame :
+//  SGLFrustum frustum; sgl_frustum_from_matrix(&frustum, view_projection, camera_position, projection[5]);
+//  sgl_cull(&objects, &frustum, &draws, &pool);  //pool is optional
+//  glBindVertexArray(...); sgl_draw_list_submit(&draws);
+//=============================================================================
+
+#ifndef SGL_CULL_MAX_LODS
+#define SGL_CULL_MAX_LODS 4
+#endif
+
+//One level of detail, a range of the bound GL_ELEMENT_ARRAY_BUFFER.
+struct SGLCullLod {
+    GLsizei index_count;
+    uint32  index_offset;   //In bytes
+};
+
+struct SGLCullObjects {
+    uint32 count;
+    uint32 capacity;
+    //AABB center and half extents. Arrays are 32 byte aligned and padded to a multiple of 8.
+    float* center_x;
+    float* center_y;
+    float* center_z;
+    float* extent_x;
+    float* extent_y;
+    float* extent_z;
+    float* radius;          //Bounding sphere radius, used for the LOD projected size
+    uint32* lod_count;
+    SGLCullLod* lods;       //capacity*SGL_CULL_MAX_LODS, LOD 0 is the most detailed
+};
+
+struct SGLFrustum {
+    //left, right, bottom, top, near, far. Planes point inwards.
+    float plane_x[6];
+    float plane_y[6];
+    float plane_z[6];
+    float plane_w[6];
+    float camera[3];
+    float lod_scale;
+    //An object drops to the next LOD when its projected size (fraction of half the screen height)
+    //falls below the threshold.
+    float lod_thresholds[SGL_CULL_MAX_LODS - 1];
+};
+
+struct SGLDrawList {
+    uint32 count;
+    uint32 capacity;
+    GLsizei* index_counts;
+    const void** index_offsets;
+    uint32* object_indices;
+    uint8* lods;
+};
+
+bool32 sgl_cull_objects_create(SGLCullObjects* objects, uint32 capacity);
+void   sgl_cull_objects_free(SGLCullObjects* objects);
+
+//Adds an object with an axis aligned box. lods - lod_count LODs, most detailed first.
+//Returns the object index.
+uint32 sgl_cull_object_add(SGLCullObjects* objects, float center_x, float center_y, float center_z,
+                           float extent_x, float extent_y, float extent_z,
+                           SGLCullLod* lods, uint32 lod_count);
+
+//Same as above for a bounding sphere (culled as the box around the sphere).
+uint32 sgl_cull_object_add_sphere(SGLCullObjects* objects, float center_x, float center_y, float center_z,
+                                  float radius, SGLCullLod* lods, uint32 lod_count);
+
+bool32 sgl_draw_list_create(SGLDrawList* list, uint32 capacity);
+void   sgl_draw_list_free(SGLDrawList* list);
+
+//Extracts the frustum planes from a column major view*projection matrix (the usual OpenGL layout).
+//camera           - camera position in world space
+//projection_scale - element [5] of the projection matrix (1/tan(fov_y/2)), used for LOD selection
+void sgl_frustum_from_matrix(SGLFrustum* frustum, const float* view_projection, const float* camera, float projection_scale);
+
+//Culls every object and fills list with the visible ones. If pool is given the work is split across it.
+void sgl_cull(SGLCullObjects* objects, SGLFrustum* frustum, SGLDrawList* list, SGLThreadPool* pool = 0);
+
+//Draws the whole list with one glMultiDrawElements call.
+void sgl_draw_list_submit(SGLDrawList* list, GLenum mode = GL_TRIANGLES, GLenum type = GL_UNSIGNED_INT);
+
+//=============================================================================
+// API - [Occlusion Culling]
+//
+// Hardware occlusion queries against cheap proxy boxes, with conditional rendering so the GPU
+// skips the real draw by itself (no CPU round trip waiting for the query result).
+//
+// Objects that were visible last time they were tested are only re-tested every
+// visible_retest_interval frames (staggered), occluded ones are re-tested every frame.
+// Query results are read back without stalling, whenever the GPU has them.
+//
+//  Every frame :
+//  sgl_occlusion_begin_frame(&occlusion, view_projection, camera_position);
+//  ...draw your big occluders (walls, terrain) normally...
+//  sgl_occlusion_issue_queries(&occlusion);
+//  for(every object)
+//      if(sgl_occlusion_begin_draw(&occlusion, index)) { ...draw... ; sgl_occlusion_end_draw(&occlusion, index); }
+//=============================================================================
+
+struct SGLOcclusionObject {
+    float center[3];
+    float extent[3];        //Half size of the proxy box
+    GLuint query;
+    uint32 last_tested_frame;
+    bool32 visible;         //Last result we read back
+    bool32 query_pending;   //Issued but not read back yet
+    bool32 conditional;     //begin_draw started a conditional render
+};
+
+struct SGLOcclusion {
+    uint32 count;
+    uint32 capacity;
+    SGLOcclusionObject* objects;
+
+    uint32 frame;
+    uint32 visible_retest_interval; //Default 4
+    GLenum query_target;            //GL_ANY_SAMPLES_PASSED_CONSERVATIVE when available
+    GLenum render_mode;             //glBeginConditionalRender mode, default GL_QUERY_WAIT
+    float view_projection[16];
+    float camera[3];
+
+    GLuint program;
+    GLuint vertex_array;
+    GLuint vertex_buffer;
+    GLuint index_buffer;
+    GLint view_projection_location;
+    GLint center_location;
+    GLint extent_location;
+
+    //Per frame counters
+    uint32 queries_issued;
+    uint32 draws_skipped;
+    uint32 draws_conditional;
+};
+
+//Needs a current GL context.
+bool32 sgl_occlusion_create(SGLOcclusion* occlusion, uint32 capacity);
+void   sgl_occlusion_free(SGLOcclusion* occlusion);
+
+//Returns the object index. Objects start out visible.
+uint32 sgl_occlusion_object_add(SGLOcclusion* occlusion, float center_x, float center_y, float center_z,
+                                float extent_x, float extent_y, float extent_z);
+void   sgl_occlusion_object_set_bounds(SGLOcclusion* occlusion, uint32 index, float center_x, float center_y, float center_z,
+                                       float extent_x, float extent_y, float extent_z);
+
+//Reads back whatever query results are ready and sets the camera for this frame.
+//view_projection - column major view*projection matrix
+//camera          - camera position in world space
+void sgl_occlusion_begin_frame(SGLOcclusion* occlusion, const float* view_projection, const float* camera);
+
+//Draws the proxy boxes (no colour or depth writes) for every object that needs testing this frame.
+//Call after your occluders are in the depth buffer.
+void sgl_occlusion_issue_queries(SGLOcclusion* occlusion);
+
+//Returns false if the object is known to be occluded and there is nothing for the GPU to decide.
+//Otherwise draw the object and call sgl_occlusion_end_draw.
+bool32 sgl_occlusion_begin_draw(SGLOcclusion* occlusion, uint32 index);
+void   sgl_occlusion_end_draw(SGLOcclusion* occlusion, uint32 index);
+
+//=============================================================================
+// API - [Binary Meshes]
+//
+// A compact mesh container meant to be memory mapped and copied straight into GPU buffers, there is
+// no parsing at load time. Layout (every blob starts on a SGL_MESH_ALIGNMENT boundary) :
+//
+//  SGLMeshHeader | vertex data | index data | SGLMeshLod table | SGLMeshMeshlet table
+//
+// Vertex data is interleaved and described by the attribute table in the header, so
+// sgl_mesh_upload can set up the vertex array by itself.
+//
+// Offline, define SGL_MESH_CONVERTER to get sgl_mesh_convert_obj which turns a .obj into this format.
+//=============================================================================
+
+#define SGL_MESH_MAGIC              0x4D4C4753  //'SGLM'
+#define SGL_MESH_VERSION            1
+#define SGL_MESH_ALIGNMENT          64
+#define SGL_MESH_MAX_ATTRIBUTES     8
+#define SGL_MESH_MAX_LODS           8
+
+//Attribute locations used by the converter and the quantizer.
+#define SGL_ATTRIBUTE_POSITION      0
+#define SGL_ATTRIBUTE_NORMAL        1
+#define SGL_ATTRIBUTE_UV            2
+#define SGL_ATTRIBUTE_TANGENT       3
+
+struct SGLMeshAttribute {
+    uint32 location;        //Shader attribute location
+    uint32 components;      //1 to 4
+    uint32 type;            //GL_FLOAT, GL_HALF_FLOAT, GL_SHORT...
+    uint32 normalized;
+    uint32 offset;          //Byte offset inside the vertex
+};
+
+struct SGLMeshLod {
+    uint32 first_index;
+    uint32 index_count;
+};
+
+//A small cluster of triangles with its bounding sphere, for finer grained culling.
+struct SGLMeshMeshlet {
+    uint32 first_index;
+    uint32 index_count;
+    float center[3];
+    float radius;
+};
+
+struct SGLMeshHeader {
+    uint32 magic;
+    uint32 version;
+    uint32 vertex_count;
+    uint32 vertex_stride;
+    uint32 index_count;
+    uint32 index_type;      //GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    uint32 attribute_count;
+    uint32 lod_count;
+    uint32 meshlet_count;
+    uint32 reserved;
+    uint64 vertex_offset;
+    uint64 vertex_size;
+    uint64 index_offset;
+    uint64 index_size;
+    uint64 lod_offset;
+    uint64 meshlet_offset;
+    float bounds_min[3];
+    float bounds_max[3];
+    SGLMeshAttribute attributes[SGL_MESH_MAX_ATTRIBUTES];
+};
+
+//A mapped mesh file, the pointers point straight into the mapping.
+struct SGLMeshFile {
+    HANDLE file;
+    HANDLE mapping;
+    uint8* data;
+    uint64 size;
+    SGLMeshHeader* header;
+    SGLMeshLod* lods;
+    SGLMeshMeshlet* meshlets;
+};
+
+//A mesh living on the GPU.
+struct SGLMesh {
+    GLuint vertex_array;
+    GLuint vertex_buffer;
+    GLuint index_buffer;
+    uint32 vertex_count;
+    uint32 index_count;
+    GLenum index_type;
+    uint32 lod_count;
+    SGLMeshLod lods[SGL_MESH_MAX_LODS];
+    float bounds_min[3];
+    float bounds_max[3];
+    bool32 position_normalized; //Positions are SGL_POSITION_SNORM16, see sgl_mesh_position_decode
+};
+
+//Maps the file and validates the header and tables. Returns false if it's not a valid mesh.
+bool32 sgl_mesh_file_open(SGLMeshFile* file, const char* path);
+void   sgl_mesh_file_close(SGLMeshFile* file);
+
+//Creates the vertex array and buffers and copies the blobs from the mapping into mapped GPU buffers.
+bool32 sgl_mesh_upload(SGLMesh* mesh, SGLMeshFile* file);
+
+//sgl_mesh_file_open + sgl_mesh_upload + sgl_mesh_file_close
+bool32 sgl_mesh_load(SGLMesh* mesh, const char* path);
+void   sgl_mesh_free(SGLMesh* mesh);
+
+//Draws one LOD of the mesh.
+void   sgl_mesh_draw(SGLMesh* mesh, uint32 lod = 0);
+
+//The scale and offset the vertex shader has to apply to the position attribute
+//(position*scale + offset). Identity unless the positions are SGL_POSITION_SNORM16.
+void   sgl_mesh_position_decode(SGLMesh* mesh, float* scale, float* offset);
+
+//=============================================================================
+// API - [Vertex Quantization]
+//
+// Packs float vertex streams into smaller GPU formats, with SSE2 (and F16C when available) encoders.
+// Every format here except SGL_NORMAL_OCTAHEDRAL_16 is decoded by the vertex fetch itself, the shader
+// still sees plain vec3/vec4 attributes :
+//
+//  positions - half floats or 16 bit normalized against the mesh bounds       12 -> 8 bytes
+//  normals   - 10:10:10:2 (GL_INT_2_10_10_10_REV) or octahedral in 2 x snorm16  12 -> 4 bytes
+//  tangents  - 10:10:10:2, handedness in the 2 bit w                             16 -> 4 bytes
+//  uvs       - half floats or 16 bit unsigned normalized                         8  -> 4 bytes
+//
+// The layout goes into a SGLMeshHeader attribute table, so sgl_mesh_upload sets up the decoding.
+//=============================================================================
+
+enum SGLPositionFormat {
+    SGL_POSITION_FLOAT,
+    SGL_POSITION_HALF,
+    SGL_POSITION_SNORM16,       //Needs sgl_mesh_position_decode in the vertex shader
+};
+
+enum SGLNormalFormat {
+    SGL_NORMAL_FLOAT,
+    SGL_NORMAL_PACKED_10_10_10_2,
+    SGL_NORMAL_OCTAHEDRAL_16,   //Better precision, decode with sgl_glsl_octahedral_decode
+};
+
+enum SGLUVFormat {
+    SGL_UV_FLOAT,
+    SGL_UV_HALF,
+    SGL_UV_UNORM16,             //Only for uvs in [0, 1]
+};
+
+struct SGLVertexFormat {
+    SGLPositionFormat position;
+    SGLNormalFormat   normal;       //Tangents are packed 10:10:10:2 unless this is SGL_NORMAL_FLOAT
+    SGLUVFormat       uv;
+};
+
+//Float input streams, any of them except positions can be null. Strides are in bytes, 0 = tightly packed.
+struct SGLVertexStreams {
+    uint32 vertex_count;
+    const float* positions;     //xyz
+    const float* normals;       //xyz, unit length
+    const float* tangents;      //xyzw, w = +1/-1 handedness
+    const float* uvs;           //uv
+    uint32 position_stride;
+    uint32 normal_stride;
+    uint32 tangent_stride;
+    uint32 uv_stride;
+};
+
+//Fills in the header's vertex layout (attributes, stride, vertex count, size and bounds) for the
+//given streams and format and, if vertices is not null, writes the interleaved packed vertices there.
+//Call it with vertices = 0 first to know how much memory it needs (header->vertex_size).
+void sgl_vertex_quantize(SGLVertexStreams* streams, SGLVertexFormat format, SGLMeshHeader* header, void* vertices);
+
+//Converts count floats to half floats (round to nearest even).
+void sgl_float_to_half(const float* source, uint16* dest, uint32 count);
+
+//GLSL for the octahedral normals, paste it in your vertex shader : vec3 sgl_oct_decode(vec2 e)
+extern const char* sgl_glsl_octahedral_decode;
+
+//=============================================================================
+// API - [Sprite Batching]
+//
+// Immediate mode 2D quads. Images are packed into texture atlases (skyline packer) and sprites are
+// bucketed by (layer, atlas, blend mode), so a frame costs one draw call per atlas per layer no matter
+// in which order you draw things. The quad vertices are generated with SSE2 straight into a mapped
+// streaming buffer when the batch ends.
+//
+// Ordering : layers are drawn in increasing order, inside a bucket sprites keep the order you drew them.
+// Sprites of the same layer in different atlases/blend modes are NOT ordered against each other,
+// put things that overlap on different layers.
+//
+// Coordinates are in pixels, origin at the top left of the viewport.
+//
+//  sgl_sprite_batch_begin(&batch, window_width, window_height);
+//  sgl_sprite_draw(&batch, &player_region, x, y, 64, 64);
+//  sgl_sprite_draw_rect(&batch, 10, 10, 200, 20, SGL_RGBA(0, 0, 0, 128));
+//  sgl_sprite_batch_end(&batch);
+//=============================================================================
+
+#ifndef SGL_ATLAS_MAX_NODES
+#define SGL_ATLAS_MAX_NODES     1024
+#endif
+#ifndef SGL_SPRITE_MAX_BUCKETS
+#define SGL_SPRITE_MAX_BUCKETS  128
+#endif
+
+//Packs a colour the way the sprite vertices want it (RGBA bytes in memory).
+#define SGL_RGBA(r, g, b, a) ((uint32)(r) | ((uint32)(g) << 8) | ((uint32)(b) << 16) | ((uint32)(a) << 24))
+
+//Where an image ended up in an atlas.
+struct SGLSpriteRegion {
+    GLuint texture;
+    float u0, v0, u1, v1;
+    int32 x, y;
+    int32 width, height;
+};
+
+struct SGLAtlasNode {
+    int32 x;
+    int32 y;
+    int32 width;
+};
+
+//An RGBA8 texture with a skyline rectangle packer.
+struct SGLAtlas {
+    GLuint texture;
+    int32 width;
+    int32 height;
+    int32 padding;          //Empty texels around every image so linear filtering doesn't bleed, default 1
+    int32 node_count;
+    SGLAtlasNode nodes[SGL_ATLAS_MAX_NODES];
+};
+
+enum SGLBlendMode {
+    SGL_BLEND_ALPHA,
+    SGL_BLEND_PREMULTIPLIED,
+    SGL_BLEND_ADDITIVE,
+    SGL_BLEND_OPAQUE,
+};
+
+//[INTERNAL]
+struct sgl_sprite {
+    float rect[4];          //x, y, width, height
+    float uv[4];            //u0, v0, u1, v1
+    uint32 color;
+    uint32 bucket;
+    uint32 pad[2];
+};
+
+//[INTERNAL]
+struct sgl_sprite_bucket {
+    int32 layer;
+    GLuint texture;
+    SGLBlendMode blend;
+    uint32 count;
+    uint32 first;           //Filled in at the end of the batch
+};
+
+struct SGLSpriteBatch {
+    uint32 capacity;
+    uint32 count;
+    sgl_sprite* sprites;
+
+    uint32 bucket_count;
+    uint32 last_bucket;
+    sgl_sprite_bucket buckets[SGL_SPRITE_MAX_BUCKETS];
+
+    int32 layer;
+    SGLBlendMode blend;
+    int32 viewport_width;
+    int32 viewport_height;
+
+    GLuint program;
+    GLint viewport_location;
+    GLint texture_location;
+    GLuint vertex_array;
+    GLuint vertex_buffer;
+    GLuint index_buffer;
+    GLuint white_texture;
+
+    //Last flush
+    uint32 draw_calls;
+    uint32 sprites_drawn;
+};
+
+//Needs a current GL context.
+bool32 sgl_atlas_create(SGLAtlas* atlas, int32 width, int32 height);
+void   sgl_atlas_free(SGLAtlas* atlas);
+
+//Packs a width x height RGBA8 image into the atlas and uploads it. Returns false if it doesn't fit.
+bool32 sgl_atlas_add(SGLAtlas* atlas, int32 width, int32 height, const void* rgba_pixels, SGLSpriteRegion* region);
+
+//Forgets everything that was packed (the texture contents stay until overwritten).
+void   sgl_atlas_clear(SGLAtlas* atlas);
+
+//capacity - sprites per flush, the batch flushes by itself when it fills up.
+bool32 sgl_sprite_batch_create(SGLSpriteBatch* batch, uint32 capacity = 1 << 16);
+void   sgl_sprite_batch_free(SGLSpriteBatch* batch);
+
+void   sgl_sprite_batch_begin(SGLSpriteBatch* batch, int32 viewport_width, int32 viewport_height);
+void   sgl_sprite_batch_set_layer(SGLSpriteBatch* batch, int32 layer);
+void   sgl_sprite_batch_set_blend(SGLSpriteBatch* batch, SGLBlendMode blend);
+void   sgl_sprite_draw(SGLSpriteBatch* batch, SGLSpriteRegion* region, float x, float y, float width, float height,
+                       uint32 color = 0xFFFFFFFF);
+//Same as above with an explicit texture and uvs.
+void   sgl_sprite_draw_uv(SGLSpriteBatch* batch, GLuint texture, float x, float y, float width, float height,
+                          float u0, float v0, float u1, float v1, uint32 color = 0xFFFFFFFF);
+//Solid colour rectangle.
+void   sgl_sprite_draw_rect(SGLSpriteBatch* batch, float x, float y, float width, float height, uint32 color);
+void   sgl_sprite_batch_end(SGLSpriteBatch* batch);
+
+//=============================================================================
+// API - [Text]
+//
+// Glyphs are rasterised once with GDI into a single channel atlas that grows on demand and, once it
+// can't grow anymore, evicts the least recently used shelf. Laid out strings ("runs") are cached by
+// hash of (font, string), so redrawing the same label is a table lookup and a copy. Everything drawn
+// between begin and end goes out in one instanced draw, all fonts share the atlas.
+//
+// Layout is simple : no kerning, no shaping beyond advances, '\n' starts a new line. UTF-8 input,
+// codepoints outside the BMP are dropped. Coordinates are pixels, (x, y) is the top left of the first line.
+//
+//  int32 mono = sgl_text_font_add(&text, "Consolas", 16);
+//  sgl_text_begin(&text, window_width, window_height);
+//  sgl_text_draw(&text, mono, 10, 10, "frame 16.6ms");
+//  sgl_text_end(&text);
+//=============================================================================
+
+#ifndef SGL_TEXT_MAX_FONTS
+#define SGL_TEXT_MAX_FONTS          16
+#endif
+#ifndef SGL_TEXT_GLYPH_CACHE_SIZE
+#define SGL_TEXT_GLYPH_CACHE_SIZE   4096        //Power of two
+#endif
+#ifndef SGL_TEXT_RUN_CACHE_SIZE
+#define SGL_TEXT_RUN_CACHE_SIZE     2048        //Power of two
+#endif
+#ifndef SGL_TEXT_RUN_ARENA_SIZE
+#define SGL_TEXT_RUN_ARENA_SIZE     (512*1024)
+#endif
+#ifndef SGL_TEXT_MAX_SHELVES
+#define SGL_TEXT_MAX_SHELVES        256
+#endif
+
+struct SGLFont {
+    HFONT handle;
+    int32 pixel_height;
+    int32 ascent;
+    int32 line_height;
+};
+
+struct SGLGlyph {
+    uint32 key;             //(font + 1) << 21 | codepoint, 0 = empty slot
+    int32 shelf;            //-1 = not in the atlas, -2 = can never be (see SGL_TEXT_GLYPH_UNPLACEABLE)
+    int16 atlas_x;
+    int16 atlas_y;
+    uint16 width;
+    uint16 height;
+    int16 bearing_x;
+    int16 bearing_y;
+    float advance;
+};
+
+//[INTERNAL]
+struct sgl_text_shelf {
+    int32 y;
+    int32 height;
+    int32 cursor;
+    uint32 last_used;       //Frame
+};
+
+//[INTERNAL]
+struct sgl_text_run {
+    uint32 hash;            //0 = empty slot
+    int32 font;
+    uint32 length;
+    uint32 string_offset;   //Into the run arena
+    uint32 glyph_offset;
+    uint32 glyph_count;
+    float width;
+    float height;
+};
+
+//[INTERNAL]
+struct sgl_text_run_glyph {
+    float x;
+    float y;
+    uint32 glyph;
+};
+
+//[INTERNAL] One per glyph on screen.
+struct sgl_text_instance {
+    float position[2];
+    uint16 atlas[4];        //x, y, width, height in texels
+    uint32 color;
+};
+
+struct SGLTextRenderer {
+    HDC dc;
+    int32 selected_font;
+    int32 font_count;
+    SGLFont fonts[SGL_TEXT_MAX_FONTS];
+
+    SGLGlyph* glyphs;
+    uint32 glyph_count;
+    sgl_text_run* runs;
+    uint32 run_count;
+    uint8* arena;
+    uint32 arena_used;
+
+    GLuint atlas;
+    int32 atlas_width;
+    int32 atlas_height;
+    int32 atlas_max_height;
+    uint8* atlas_pixels;    //CPU copy, so the atlas can grow without a read back
+    int32 shelf_count;
+    int32 shelf_bottom;
+    sgl_text_shelf shelves[SGL_TEXT_MAX_SHELVES];
+    uint8* scratch;         //GDI glyph bitmap
+
+    sgl_text_instance* instances;
+    uint32 instance_capacity;
+    uint32 instance_count;
+
+    uint32 frame;
+    int32 viewport_width;
+    int32 viewport_height;
+
+    GLuint program;
+    GLint viewport_location;
+    GLint texture_location;
+    GLuint vertex_array;
+    GLuint instance_buffer;
+
+    //Last frame
+    uint32 draw_calls;
+    uint32 glyphs_drawn;
+    //Lifetime
+    uint32 glyphs_rasterized;
+    uint32 runs_built;
+};
+
+//Needs a current GL context. instance_capacity - glyphs per draw, more than that costs an extra draw call.
+bool32 sgl_text_create(SGLTextRenderer* text, uint32 instance_capacity = 1 << 16);
+void   sgl_text_free(SGLTextRenderer* text);
+
+//pixel_height is the em height, weight is a GDI weight (FW_NORMAL, FW_BOLD...). Returns the font index or -1.
+int32  sgl_text_font_add(SGLTextRenderer* text, const char* face, int32 pixel_height, int32 weight = FW_NORMAL);
+
+void   sgl_text_begin(SGLTextRenderer* text, int32 viewport_width, int32 viewport_height);
+void   sgl_text_draw(SGLTextRenderer* text, int32 font, float x, float y, const char* string, uint32 color = 0xFFFFFFFF);
+//Size of the string's box in pixels (uses and fills the same run cache as draw).
+void   sgl_text_measure(SGLTextRenderer* text, int32 font, const char* string, float* width, float* height);
+void   sgl_text_end(SGLTextRenderer* text);
+
+//=============================================================================
+// API - [Render Targets]
+//
+// A framebuffer with a colour texture and an optional depth texture, for when you just want to render
+// somewhere else. Multi-pass pipelines should rather go through the render graph below.
+//=============================================================================
+
+//Internal format + size of a render texture.
+struct SGLTextureDesc {
+    int32 width;
+    int32 height;
+    GLenum format;      //GL_RGBA8, GL_RGBA16F, GL_DEPTH24_STENCIL8...
+};
+
+struct SGLRenderTarget {
+    GLuint framebuffer;
+    GLuint color;
+    GLuint depth;
+    int32 width;
+    int32 height;
+};
+
+//depth_format = 0 for no depth attachment. Returns false if the framebuffer isn't complete.
+bool32 sgl_render_target_create(SGLRenderTarget* target, int32 width, int32 height,
+                                GLenum color_format = GL_RGBA8, GLenum depth_format = GL_DEPTH24_STENCIL8);
+void   sgl_render_target_free(SGLRenderTarget* target);
+//Binds it for drawing and sets the viewport. Null binds the default framebuffer (viewport untouched).
+void   sgl_render_target_bind(SGLRenderTarget* target);
+
+//=============================================================================
+// API - [Render Graph]
+//
+// Build the frame as passes that declare the textures they read and write, then execute it :
+//  - passes whose results nobody uses (not the backbuffer, not an imported texture, not read by a live
+//    pass) are culled,
+//  - every transient texture gets a lifetime (first to last live pass touching it),
+//  - transient textures with the same description and non overlapping lifetimes share one texture
+//    from a pool that lives across frames, unused pool textures are freed after a few frames.
+// GL can't alias memory between different formats, so sharing happens between identical descriptions,
+// which is what ping-ponging post chains are made of anyway.
+//
+//  sgl_render_graph_begin(&graph);
+//  SGLGraphResource hdr   = sgl_render_graph_create_texture(&graph, "hdr", {width, height, GL_RGBA16F});
+//  SGLGraphResource depth = sgl_render_graph_create_texture(&graph, "depth", {width, height, GL_DEPTH24_STENCIL8});
+//  SGLGraphResource back  = sgl_render_graph_backbuffer(&graph, width, height);
+//  int32 scene = sgl_render_graph_add_pass(&graph, "scene", draw_scene, &game);
+//  sgl_render_graph_write(&graph, scene, hdr);
+//  sgl_render_graph_write(&graph, scene, depth);
+//  sgl_render_graph_clear(&graph, scene, GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT, 0, 0, 0, 1);
+//  int32 tonemap = sgl_render_graph_add_pass(&graph, "tonemap", draw_tonemap, &game);
+//  sgl_render_graph_read(&graph, tonemap, hdr);
+//  sgl_render_graph_write(&graph, tonemap, back);
+//  sgl_render_graph_execute(&graph);
+//
+// Inside a pass the framebuffer is bound and the viewport set, sgl_render_graph_texture gives the
+// texture behind a resource. A pass can't read a texture it writes, and a pass writing the backbuffer
+// can't write anything else. Passes whose framebuffer comes out incomplete are skipped (and reported).
+//=============================================================================
+
+#ifndef SGL_RENDER_GRAPH_MAX_PASSES
+#define SGL_RENDER_GRAPH_MAX_PASSES         64
+#endif
+#ifndef SGL_RENDER_GRAPH_MAX_RESOURCES
+#define SGL_RENDER_GRAPH_MAX_RESOURCES      128
+#endif
+#ifndef SGL_RENDER_GRAPH_MAX_POOL
+#define SGL_RENDER_GRAPH_MAX_POOL           64
+#endif
+#define SGL_RENDER_GRAPH_MAX_PASS_IO        8
+#define SGL_RENDER_GRAPH_MAX_COLOR          4
+#define SGL_RENDER_POOL_IDLE_FRAMES         8
+
+typedef int32 SGLGraphResource;
+struct SGLRenderGraph;
+typedef void sgl_render_pass_func(SGLRenderGraph* graph, void* data);
+
+enum {
+    SGL_GRAPH_RESOURCE_EXTERNAL   = 0x1,   //Imported, the graph doesn't own it and its contents are kept
+    SGL_GRAPH_RESOURCE_BACKBUFFER = 0x2,
+};
+
+//[INTERNAL]
+struct sgl_graph_resource {
+    const char* name;
+    SGLTextureDesc desc;
+    uint32 flags;
+    GLuint texture;
+    int32 first_pass;
+    int32 last_pass;
+    bool32 needed;
+    bool32 written;         //By a live pass, so far in this frame's pass order
+};
+
+//[INTERNAL]
+struct sgl_graph_pass {
+    const char* name;
+    sgl_render_pass_func* func;
+    void* data;
+    SGLGraphResource reads[SGL_RENDER_GRAPH_MAX_PASS_IO];
+    SGLGraphResource writes[SGL_RENDER_GRAPH_MAX_PASS_IO];
+    int32 read_count;
+    int32 write_count;
+    GLbitfield clear_mask;
+    float clear_color[4];
+    bool32 live;
+};
+
+//[INTERNAL]
+struct sgl_render_pool_texture {
+    GLuint texture;
+    SGLTextureDesc desc;
+    uint32 last_frame;
+    int32 busy_until;       //Last pass of the resource currently living in it, this frame
+};
+
+//[INTERNAL]
+struct sgl_render_pool_framebuffer {
+    GLuint framebuffer;
+    GLuint attachments[SGL_RENDER_GRAPH_MAX_COLOR + 1];    //Colours then depth
+    uint32 last_frame;
+    bool32 incomplete;      //Kept so the combination isn't retried (and reported) every frame
+};
+
+struct SGLRenderGraphStats {
+    uint32 passes;
+    uint32 passes_culled;
+    uint32 transient_textures;
+    uint32 pool_textures;
+    uint64 transient_bytes;     //What the transient textures would cost without sharing
+    uint64 pool_bytes;          //What the pool actually holds
+    uint32 passes_skipped;      //Live passes whose framebuffer was incomplete
+    uint32 uninitialized_reads; //Transients read before any live pass wrote them
+};
+
+struct SGLRenderGraph {
+    uint32 frame;
+    int32 pass_count;
+    int32 resource_count;
+    sgl_graph_pass passes[SGL_RENDER_GRAPH_MAX_PASSES];
+    sgl_graph_resource resources[SGL_RENDER_GRAPH_MAX_RESOURCES];
+
+    int32 pool_count;
+    sgl_render_pool_texture pool[SGL_RENDER_GRAPH_MAX_POOL];
+    int32 framebuffer_count;
+    sgl_render_pool_framebuffer framebuffers[SGL_RENDER_GRAPH_MAX_POOL];
+
+    SGLRenderGraphStats stats;
+    bool32 warned_uninitialized;
+};
+
+void sgl_render_graph_create(SGLRenderGraph* graph);
+//Deletes every pooled texture and framebuffer.
+void sgl_render_graph_free(SGLRenderGraph* graph);
+
+//Starts building a frame, resources and passes from the previous one are forgotten (the pool isn't).
+void sgl_render_graph_begin(SGLRenderGraph* graph);
+//Names must outlive the frame (string literals).
+SGLGraphResource sgl_render_graph_create_texture(SGLRenderGraph* graph, const char* name, SGLTextureDesc desc);
+SGLGraphResource sgl_render_graph_import_texture(SGLRenderGraph* graph, const char* name, GLuint texture, SGLTextureDesc desc);
+SGLGraphResource sgl_render_graph_backbuffer(SGLRenderGraph* graph, int32 width, int32 height);
+
+int32 sgl_render_graph_add_pass(SGLRenderGraph* graph, const char* name, sgl_render_pass_func* func, void* data);
+void  sgl_render_graph_read(SGLRenderGraph* graph, int32 pass, SGLGraphResource resource);
+//Colour writes become attachments 0, 1, 2... in call order, a depth format goes to the depth attachment.
+//Returns false (and drops the write) when it would mix the backbuffer with textures in one pass.
+bool32 sgl_render_graph_write(SGLRenderGraph* graph, int32 pass, SGLGraphResource resource);
+void  sgl_render_graph_clear(SGLRenderGraph* graph, int32 pass, GLbitfield mask, float r, float g, float b, float a);
+
+void   sgl_render_graph_execute(SGLRenderGraph* graph);
+//Only valid while executing.
+GLuint sgl_render_graph_texture(SGLRenderGraph* graph, SGLGraphResource resource);
+
+//=============================================================================
+// API - [Tiled Rendering]
+//
+// Renders images bigger than any framebuffer (posters, maps) one framebuffer sized tile at a time.
+// Tiles go top to bottom, left to right. Each finished tile is read back into a pixel buffer without
+// waiting, and only mapped a few tiles later when the GPU is long done with it, then its rows are handed
+// to a writer. GPU memory is the tile target plus SGL_TILE_PIPELINE_DEPTH pixel buffers and CPU memory
+// is one row, whatever the size of the output.
+//
+//  SGLTiledRender tiles;
+//  sgl_tiled_render_begin_file(&tiles, 40000, 30000, "poster.ppm");
+//  SGLTile tile;
+//  while(sgl_tiled_render_next(&tiles, &tile))
+//  {
+//      float projection[16];
+//      sgl_tile_projection(&tile, full_projection, projection);
+//      ... draw the whole scene with projection ...
+//  }
+//  if(!sgl_tiled_render_end(&tiles)) ... the image is incomplete (write or read back failed) ...
+//=============================================================================
+
+#ifndef SGL_TILE_PIPELINE_DEPTH
+#define SGL_TILE_PIPELINE_DEPTH 3
+#endif
+
+//Gets the image row by row as tiles complete : width RGBA8 pixels starting at (x, y), y = 0 is the top row.
+typedef void sgl_tile_writer_func(void* user, int32 x, int32 y, int32 width, const uint8* rgba);
+
+struct SGLTile {
+    int32 x;                //Top left of the tile in the output image, in pixels
+    int32 y;
+    int32 width;
+    int32 height;
+    int32 index;
+    float ndc[4];           //Area of the full image's NDC the tile covers : left, bottom, right, top
+};
+
+//[INTERNAL]
+struct sgl_tile_readback {
+    GLuint buffer;
+    GLsync fence;
+    SGLTile tile;
+};
+
+struct SGLTiledRender {
+    int32 width;
+    int32 height;
+    int32 tile_size;
+    int32 columns;
+    int32 rows;
+    int32 next_tile;
+
+    SGLRenderTarget target;
+    bool32 rendering;       //A tile is bound and being drawn
+    SGLTile current;
+    uint32 first_pending;
+    uint32 pending_count;
+    sgl_tile_readback readbacks[SGL_TILE_PIPELINE_DEPTH];
+
+    sgl_tile_writer_func* writer;
+    void* user;
+    uint8* row;             //Flipped / converted row for the writer
+
+    //Built in PPM writer
+    HANDLE file;
+    uint64 file_header_size;
+
+    uint32 stalls;          //Times a read back wasn't finished when we needed it
+    bool32 failed;          //A write or a read back went wrong, the output is incomplete. Survives end.
+};
+
+//tile_size = 0 picks the biggest framebuffer the driver allows (capped at 4096), never more than the image needs.
+bool32 sgl_tiled_render_begin(SGLTiledRender* render, int32 width, int32 height, sgl_tile_writer_func* writer, void* user,
+                              int32 tile_size = 0);
+//Same, writing a binary PPM (RGB, alpha is dropped) straight to disk.
+bool32 sgl_tiled_render_begin_file(SGLTiledRender* render, int32 width, int32 height, const char* ppm_path,
+                                   int32 tile_size = 0);
+//Finishes the previous tile and binds the next one (framebuffer + viewport). Returns false once every tile
+//has been drawn and written, or as soon as something failed. Everything is released by then.
+bool32 sgl_tiled_render_next(SGLTiledRender* render, SGLTile* tile);
+//Releases everything (stopping early if tiles are left). Returns true only if the whole image was written,
+//safe to call again after next returned false to get that result.
+bool32 sgl_tiled_render_end(SGLTiledRender* render);
+
+//Narrows a column major projection matrix (perspective or orthographic) to the tile's part of the screen.
+void   sgl_tile_projection(SGLTile* tile, const float* projection, float* tile_projection);
+
+//=============================================================================
+// API - [Compute]
+//
+// Compute programs, shader storage buffers and dispatches (GL 4.3). Writes from a dispatch are not
+// visible to anything else until a glMemoryBarrier with the right bits, the library keeps track of
+// which buffers were written since which barrier and issues only the bits the next use needs :
+// dispatches reading/writing a buffer, indirect dispatches, uploads and read backs do it for you,
+// call sgl_storage_buffer_barrier before drawing from a buffer a dispatch wrote.
+//
+//  SGLComputeProgram integrate; sgl_compute_program_create(&integrate, integrate_source);
+//  SGLStorageBuffer particles;  sgl_storage_buffer_create(&particles, count*sizeof(Particle), data);
+//  SGLComputeBinding bindings[] = {{&particles, 0, true}};
+//  sgl_compute_dispatch(&integrate, bindings, 1, sgl_compute_groups(count, integrate.local_size[0]));
+//  sgl_storage_buffer_barrier(&particles, SGL_BUFFER_USE_VERTEX);
+//  ... draw with particles.buffer as a vertex buffer ...
+//
+//  Reading results back without stalling :
+//  sgl_compute_readback_begin(&readback, &particles, 0, particles.size);
+//  ... frames later ...
+//  if(sgl_compute_readback_ready(&readback)) { const void* data = sgl_compute_readback_map(&readback); ... unmap }
+//=============================================================================
+
+//How a buffer written by a dispatch is about to be used.
+enum SGLBufferUse {
+    SGL_BUFFER_USE_STORAGE  = 0x01,     //Shader storage in a later dispatch or draw
+    SGL_BUFFER_USE_VERTEX   = 0x02,
+    SGL_BUFFER_USE_INDEX    = 0x04,
+    SGL_BUFFER_USE_INDIRECT = 0x08,     //Draw/dispatch indirect arguments
+    SGL_BUFFER_USE_UNIFORM  = 0x10,
+    SGL_BUFFER_USE_UPDATE   = 0x20,     //glBufferSubData, copies, mapping, read backs
+};
+#define SGL_BUFFER_USE_COUNT 6
+
+struct SGLComputeProgram {
+    GLuint program;
+    int32 local_size[3];    //From the shader's layout(local_size_x...)
+};
+
+struct SGLStorageBuffer {
+    GLuint buffer;
+    uint64 size;
+    uint64 write_sequence;  //[INTERNAL] last dispatch that wrote it
+};
+
+struct SGLComputeBinding {
+    SGLStorageBuffer* buffer;
+    uint32 binding;         //layout(binding = N) of the buffer block
+    bool32 writes;
+};
+
+struct SGLComputeReadback {
+    GLuint buffer;          //Staging buffer, grows as needed
+    uint64 capacity;
+    uint64 size;
+    GLsync fence;
+    void* mapped;
+};
+
+//Compute needs GL 4.3 (or ARB_compute_shader), check this before anything else.
+bool32 sgl_compute_supported();
+
+bool32 sgl_compute_program_create(SGLComputeProgram* program, const char* source, char* debug_name = 0);
+void   sgl_compute_program_free(SGLComputeProgram* program);
+//Work groups needed to cover item_count items, 0 if local_size isn't positive.
+uint32 sgl_compute_groups(uint32 item_count, int32 local_size);
+
+bool32 sgl_storage_buffer_create(SGLStorageBuffer* buffer, uint64 size, const void* data = 0, GLenum usage = GL_DYNAMIC_COPY);
+void   sgl_storage_buffer_free(SGLStorageBuffer* buffer);
+void   sgl_storage_buffer_upload(SGLStorageBuffer* buffer, uint64 offset, const void* data, uint64 size);
+//uses - SGLBufferUse flags
+void   sgl_storage_buffer_barrier(SGLStorageBuffer* buffer, uint32 uses);
+
+void   sgl_compute_dispatch(SGLComputeProgram* program, SGLComputeBinding* bindings, int32 binding_count,
+                            uint32 groups_x, uint32 groups_y = 1, uint32 groups_z = 1);
+//The group counts are 3 uint32 at offset in arguments, possibly written by an earlier dispatch.
+void   sgl_compute_dispatch_indirect(SGLComputeProgram* program, SGLComputeBinding* bindings, int32 binding_count,
+                                     SGLStorageBuffer* arguments, uint64 offset = 0);
+
+//Copies size bytes of source into the staging buffer on the GPU and fences it, nothing waits here.
+void   sgl_compute_readback_begin(SGLComputeReadback* readback, SGLStorageBuffer* source, uint64 offset, uint64 size);
+bool32 sgl_compute_readback_ready(SGLComputeReadback* readback);
+//Blocks if the copy isn't done yet. Valid until unmap.
+const void* sgl_compute_readback_map(SGLComputeReadback* readback);
+void   sgl_compute_readback_unmap(SGLComputeReadback* readback);
+void   sgl_compute_readback_free(SGLComputeReadback* readback);
+
+#ifdef SGL_MESH_CONVERTER
+//Converts a triangulated or polygonal .obj (positions, normals, uvs) into a mesh file.
+//Vertices are deduplicated, faces are fan triangulated and meshlets of up to 64 triangles are built.
+//format - how to pack the vertices, null = everything stays float
+bool32 sgl_mesh_convert_obj(const char* obj_path, const char* mesh_path, SGLVertexFormat* format = 0);
+#endif //SGL_MESH_CONVERTER
+
+//=============================================================================
+// API - [GPU Memory]
+//
+// Every buffer, texture and program the library creates is recorded with its size, format and the
+// function/line that created it. Live totals and high water marks per category can be queried at any
+// time, sgl_window_destroy prints whatever is still alive as a leak report.
+//
+// Your own objects can join in with SGL_GPU_TRACK / sgl_gpu_memory_untrack, the call site is recorded for you.
+// Sizes are what we asked GL for (no mips, no driver padding), programs count but weigh 0 bytes.
+//=============================================================================
+
+#ifndef SGL_GPU_TRACK_CAPACITY
+#define SGL_GPU_TRACK_CAPACITY 16384    //Power of two, objects beyond that only show up as untracked
+#endif
+
+enum SGLGpuCategory {
+    SGL_GPU_BUFFER,
+    SGL_GPU_TEXTURE,
+    SGL_GPU_RENDERBUFFER,
+    SGL_GPU_PROGRAM,
+
+    SGL_GPU_CATEGORY_COUNT
+};
+
+struct SGLGpuMemoryStats {
+    uint64 live_bytes[SGL_GPU_CATEGORY_COUNT];
+    uint64 peak_bytes[SGL_GPU_CATEGORY_COUNT];
+    uint32 live_objects[SGL_GPU_CATEGORY_COUNT];
+    uint32 peak_objects[SGL_GPU_CATEGORY_COUNT];
+    uint64 total_live_bytes;
+    uint64 total_peak_bytes;
+    uint64 budget_bytes;        //0 = none
+    uint32 untracked;           //Objects that didn't fit the table
+};
+
+//Records (or updates, if it's already known) an object. bytes is its full size, format its internal format or 0.
+#define SGL_GPU_TRACK(category, name, bytes, format, label) sgl_gpu_memory_track(category, name, bytes, format, label, __FUNCTION__, __LINE__)
+void   sgl_gpu_memory_track(SGLGpuCategory category, GLuint name, uint64 bytes, GLenum format, const char* label,
+                            const char* function, int32 line);
+void   sgl_gpu_memory_untrack(SGLGpuCategory category, GLuint name);
+
+void   sgl_gpu_memory_get_stats(SGLGpuMemoryStats* stats);
+//Warns on stderr the first time the live total goes over budget_bytes. 0 disables it.
+void   sgl_gpu_memory_set_budget(uint64 budget_bytes);
+//Prints every live object to stderr, returns how many there were.
+uint32 sgl_gpu_memory_report_leaks();
+//Forgets every record and zeroes the stats (the budget stays). sgl_window_destroy does it after the report.
+void   sgl_gpu_memory_reset();
+
+//END API -------------------------------
+
+//===============================================================================  
+// [IMPLEMENTATION]
+//=============================================================================== 
+#ifdef SIMPLE_OGL_IMPLEMENTATION
+
+//
+//[OpenGL Functions] ---------------------
+
+//@TODO: Explain this bit more
+//Macro for Declaring OpenGL Function Pointers
+#define DECLARE_GL_FUNC_PTR(return_type, func_name, params) typedef return_type func_name##_func_signature params; \
+                                                            func_name##_func_signature *func_name = nullptr; 
+
+#ifdef _WIN32
+//Macro for getting the adress of the given OpenGL function and checking we have a valid address (not null).
+#define GET_GL_FUNC_SAFE(name) name = (name##_func_signature *)wglGetProcAddress(#name); \
+                               SGL_Assert(name);
+//Same as above but allows the function to be missing (extensions), check for null before calling it.
+#define GET_GL_FUNC(name) name = (name##_func_signature *)wglGetProcAddress(#name);
+#else
+    //@TODO: Other OS
+   #error No other OS defined!
+#endif //_WIN32
+
+//[OpenGL Function Declarations] --------------------------------------------------------------------------------
+
+	DECLARE_GL_FUNC_PTR(void, glActiveTexture, (GLenum))
+	DECLARE_GL_FUNC_PTR(void, glMultiDrawElements, (GLenum, const GLsizei *, GLenum, const void *const *, GLsizei))
+	DECLARE_GL_FUNC_PTR(void, glEnableVertexAttribArray, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glDisableVertexAttribArray, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glVertexAttribPointer, (GLuint, GLint, GLenum, GLboolean, GLsizei, const void *))
+	DECLARE_GL_FUNC_PTR(void, glGenBuffers, (GLsizei, GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glDeleteBuffers, (GLsizei, const GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glBindBuffer, (GLenum, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glBufferData, (GLenum, GLsizeiptr, const void *, GLenum))
+	DECLARE_GL_FUNC_PTR(void *, glMapBuffer, (GLenum, GLenum))
+	DECLARE_GL_FUNC_PTR(GLboolean, glUnmapBuffer, (GLenum))
+	DECLARE_GL_FUNC_PTR(GLuint, glCreateShader, (GLenum))
+	DECLARE_GL_FUNC_PTR(void, glDeleteShader, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glShaderSource, (GLuint, GLsizei, const GLchar **, const GLint *))
+	DECLARE_GL_FUNC_PTR(void, glCompileShader, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glAttachShader, (GLuint, GLuint))
+	DECLARE_GL_FUNC_PTR(GLuint, glCreateProgram, (void))
+	DECLARE_GL_FUNC_PTR(void, glDeleteProgram, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glLinkProgram, (GLuint))
+	DECLARE_GL_FUNC_PTR(void, glUseProgram, (GLuint))
+	DECLARE_GL_FUNC_PTR(GLint, glGetUniformLocation, (GLuint, const GLchar *))
+	DECLARE_GL_FUNC_PTR(void, glUniform1i, (GLint, GLint))
+	DECLARE_GL_FUNC_PTR(void, glUniform4f, (GLint, GLfloat, GLfloat, GLfloat, GLfloat))
+	DECLARE_GL_FUNC_PTR(void, glUniform4fv, (GLint, GLsizei, const GLfloat *))
+	DECLARE_GL_FUNC_PTR(void, glUniform2f, (GLint, GLfloat, GLfloat))
+	DECLARE_GL_FUNC_PTR(void, glDrawArraysInstanced, (GLenum, GLint, GLsizei, GLsizei))
+	DECLARE_GL_FUNC_PTR(void, glVertexAttribDivisor, (GLuint, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glBlendFuncSeparate, (GLenum, GLenum, GLenum, GLenum))
+	DECLARE_GL_FUNC_PTR(void, glGenFramebuffers, (GLsizei, GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glDeleteFramebuffers, (GLsizei, const GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glBindFramebuffer, (GLenum, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glFramebufferTexture2D, (GLenum, GLenum, GLenum, GLuint, GLint))
+	DECLARE_GL_FUNC_PTR(GLenum, glCheckFramebufferStatus, (GLenum))
+	DECLARE_GL_FUNC_PTR(void, glDrawBuffers, (GLsizei, const GLenum *))
+	DECLARE_GL_FUNC_PTR(GLsync, glFenceSync, (GLenum, GLbitfield))
+	DECLARE_GL_FUNC_PTR(GLenum, glClientWaitSync, (GLsync, GLbitfield, GLuint64))
+	DECLARE_GL_FUNC_PTR(void, glDeleteSync, (GLsync))
+	DECLARE_GL_FUNC_PTR(void, glBufferSubData, (GLenum, GLintptr, GLsizeiptr, const void *))
+	DECLARE_GL_FUNC_PTR(void, glCopyBufferSubData, (GLenum, GLenum, GLintptr, GLintptr, GLsizeiptr))
+	DECLARE_GL_FUNC_PTR(void, glBindBufferBase, (GLenum, GLuint, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glDispatchCompute, (GLuint, GLuint, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glDispatchComputeIndirect, (GLintptr))
+	DECLARE_GL_FUNC_PTR(void, glMemoryBarrier, (GLbitfield))
+	DECLARE_GL_FUNC_PTR(void, glGenQueries, (GLsizei, GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glDeleteQueries, (GLsizei, const GLuint *))
+	DECLARE_GL_FUNC_PTR(void, glBeginQuery, (GLenum, GLuint))
+	DECLARE_GL_FUNC_PTR(void, glEndQuery, (GLenum))
+    DECLARE_GL_FUNC_PTR(void, glGenVertexArrays, (GLsizei, GLuint *))
+    DECLARE_GL_FUNC_PTR(void, glDeleteVertexArrays, (GLsizei, const GLuint *))
+    DECLARE_GL_FUNC_PTR(void, glBindVertexArray, (GLuint))
+    DECLARE_GL_FUNC_PTR(void, glGetShaderiv, (GLuint, GLenum, GLint *))
+    DECLARE_GL_FUNC_PTR(void, glGetShaderInfoLog, (GLuint, GLsizei, GLsizei, GLchar *))
+    DECLARE_GL_FUNC_PTR(void, glGetProgramiv, (GLuint, GLenum, GLint *)) 
+    DECLARE_GL_FUNC_PTR(void, glGetProgramInfoLog, (GLuint, GLsizei, GLsizei *, GLchar *))
+    DECLARE_GL_FUNC_PTR(void, glDetachShader, (GLuint, GLuint))
+    DECLARE_GL_FUNC_PTR(void, glDebugMessageCallback, (GLDEBUGPROC, const void *))
+    DECLARE_GL_FUNC_PTR(void, glDebugMessageControl, (GLenum, GLenum, GLenum, GLsizei, const GLuint *, GLboolean))
+    DECLARE_GL_FUNC_PTR(void, glObjectLabel, (GLenum, GLuint, GLsizei, const GLchar *))
+    DECLARE_GL_FUNC_PTR(void, glPushDebugGroup, (GLenum, GLuint, GLsizei, const GLchar *))
+    DECLARE_GL_FUNC_PTR(void, glPopDebugGroup, (void))
+    DECLARE_GL_FUNC_PTR(void, glGetQueryObjectuiv, (GLuint, GLenum, GLuint *))
+    DECLARE_GL_FUNC_PTR(void, glBeginConditionalRender, (GLuint, GLenum))
+    DECLARE_GL_FUNC_PTR(void, glEndConditionalRender, (void))
+    DECLARE_GL_FUNC_PTR(void, glUniform3fv, (GLint, GLsizei, const GLfloat *))
+    DECLARE_GL_FUNC_PTR(void, glUniformMatrix4fv, (GLint, GLsizei, GLboolean, const GLfloat *))
+    DECLARE_GL_FUNC_PTR(void *, glMapBufferRange, (GLenum, GLintptr, GLsizeiptr, GLbitfield))
+    
+    //[DECLARE NEW GL FUNCTION]
+    //Declare any new functions here...
+
+//[END OpenGL Function Delarations] -------------------------------------------------------------------------------------------------------
+
+void sgl_load_gl_functions()
+{
+    GET_GL_FUNC_SAFE(glActiveTexture)
+	GET_GL_FUNC_SAFE(glMultiDrawElements)
+	GET_GL_FUNC_SAFE(glEnableVertexAttribArray)
+	GET_GL_FUNC_SAFE(glDisableVertexAttribArray)
+	GET_GL_FUNC_SAFE(glVertexAttribPointer)
+	GET_GL_FUNC_SAFE(glGenBuffers)
+	GET_GL_FUNC_SAFE(glDeleteBuffers)
+	GET_GL_FUNC_SAFE(glBindBuffer)
+	GET_GL_FUNC_SAFE(glBufferData)
+	GET_GL_FUNC_SAFE(glMapBuffer)
+	GET_GL_FUNC_SAFE(glUnmapBuffer)
+	GET_GL_FUNC_SAFE(glCreateShader)
+	GET_GL_FUNC_SAFE(glDeleteShader)
+	GET_GL_FUNC_SAFE(glShaderSource)
+	GET_GL_FUNC_SAFE(glCompileShader)
+	GET_GL_FUNC_SAFE(glAttachShader)
+	GET_GL_FUNC_SAFE(glCreateProgram)
+	GET_GL_FUNC_SAFE(glDeleteProgram)
+	GET_GL_FUNC_SAFE(glLinkProgram)
+	GET_GL_FUNC_SAFE(glUseProgram)
+	GET_GL_FUNC_SAFE(glGetUniformLocation)
+	GET_GL_FUNC_SAFE(glUniform1i)
+	GET_GL_FUNC_SAFE(glUniform4f)
+	GET_GL_FUNC_SAFE(glUniform4fv)
+	GET_GL_FUNC_SAFE(glUniform2f)
+	GET_GL_FUNC_SAFE(glDrawArraysInstanced)
+	GET_GL_FUNC_SAFE(glVertexAttribDivisor)
+	GET_GL_FUNC_SAFE(glBlendFuncSeparate)
+	GET_GL_FUNC_SAFE(glGenFramebuffers)
+	GET_GL_FUNC_SAFE(glDeleteFramebuffers)
+	GET_GL_FUNC_SAFE(glBindFramebuffer)
+	GET_GL_FUNC_SAFE(glFramebufferTexture2D)
+	GET_GL_FUNC_SAFE(glCheckFramebufferStatus)
+	GET_GL_FUNC_SAFE(glDrawBuffers)
+	GET_GL_FUNC_SAFE(glFenceSync)
+	GET_GL_FUNC_SAFE(glClientWaitSync)
+	GET_GL_FUNC_SAFE(glDeleteSync)
+	GET_GL_FUNC_SAFE(glBufferSubData)
+	GET_GL_FUNC_SAFE(glCopyBufferSubData)
+	GET_GL_FUNC_SAFE(glBindBufferBase)
+	GET_GL_FUNC_SAFE(glGenQueries)
+	GET_GL_FUNC_SAFE(glDeleteQueries)
+	GET_GL_FUNC_SAFE(glBeginQuery)
+	GET_GL_FUNC_SAFE(glEndQuery)
+    GET_GL_FUNC_SAFE(glGenVertexArrays)
+    GET_GL_FUNC_SAFE(glDeleteVertexArrays)
+    GET_GL_FUNC_SAFE(glBindVertexArray)
+    GET_GL_FUNC_SAFE(glGetShaderiv)
+    GET_GL_FUNC_SAFE(glGetShaderInfoLog)
+    GET_GL_FUNC_SAFE(glGetProgramiv)
+    GET_GL_FUNC_SAFE(glGetProgramInfoLog)
+    GET_GL_FUNC_SAFE(glDetachShader)
+    GET_GL_FUNC_SAFE(glGetQueryObjectuiv)
+    GET_GL_FUNC_SAFE(glBeginConditionalRender)
+    GET_GL_FUNC_SAFE(glEndConditionalRender)
+    GET_GL_FUNC_SAFE(glUniform3fv)
+    GET_GL_FUNC_SAFE(glUniformMatrix4fv)
+    GET_GL_FUNC_SAFE(glMapBufferRange)
+    //@NOTE: KHR_debug is core only since 4.3, these are allowed to be missing.
+    GET_GL_FUNC(glDebugMessageCallback)
+    GET_GL_FUNC(glDebugMessageControl)
+    GET_GL_FUNC(glObjectLabel)
+    GET_GL_FUNC(glPushDebugGroup)
+    GET_GL_FUNC(glPopDebugGroup)
+    //@NOTE: Compute is 4.3, see sgl_compute_supported.
+    GET_GL_FUNC(glDispatchCompute)
+    GET_GL_FUNC(glDispatchComputeIndirect)
+    GET_GL_FUNC(glMemoryBarrier)
+
+    //[LOAD NEW FUNCTION]
+    // Load any other functions you might need here.
+}
+//
+//[END OpenGL Functions] ---------------------
+
+//
+//[Framebuffer Config] ---------------------
+
+SGLFramebufferConfig
+sgl_framebuffer_config_default()
+{
+    SGLFramebufferConfig config = {};
+    config.initialized   = true;
+    config.color_bits    = 24;
+    config.alpha_bits    = 8;
+    config.depth_bits    = 24;
+    config.stencil_bits  = 8;
+    config.samples       = 0;
+    config.srgb          = false;
+    config.double_buffer = true;
+    return config;
+}
+
+SGLFramebufferConfig
+sgl_framebuffer_config_lean()
+{
+    SGLFramebufferConfig config = sgl_framebuffer_config_default();
+    config.alpha_bits   = 0;
+    config.depth_bits   = 0;
+    config.stencil_bits = 0;
+    return config;
+}
+
+void
+sgl_window_framebuffer_setup(SGLWindow* window, SGLFramebufferConfig config)
+{
+    config.initialized = true;
+    window->framebuffer = config;
+}
+
+//@NOTE: How far a candidate config is from the one we asked for, lower is better.
+//Bits over what was asked are wasted bandwidth so they count against the candidate, missing bits count a lot more.
+internal int32
+sgl_internal_framebuffer_config_distance(SGLFramebufferConfig* desired, SGLFramebufferConfig* candidate)
+{
+    int32 distance = 0;
+    int32 desired_values[]   = {desired->color_bits, desired->alpha_bits, desired->depth_bits, desired->stencil_bits, desired->samples};
+    int32 candidate_values[] = {candidate->color_bits, candidate->alpha_bits, candidate->depth_bits, candidate->stencil_bits, candidate->samples};
+    for(int32 index = 0; index < 5; ++index)
+    {
+        int32 diff = candidate_values[index] - desired_values[index];
+        distance += (diff >= 0) ? diff : -diff*16;
+    }
+    if(desired->srgb != candidate->srgb)                   distance += 64;
+    if(desired->double_buffer != candidate->double_buffer) distance += 256;
+    return distance;
+}
+
+//[END Framebuffer Config] ---------------------
+
+//
+//[Debug Output] ---------------------
+
+//FNV-1a
+internal uint32
+sgl_internal_hash32(const void* data, size_t size, uint32 hash = 2166136261u)
+{
+    const uint8* bytes = (const uint8*)data;
+    for(size_t index = 0; index < size; ++index)
+    {
+        hash ^= bytes[index];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+#define SGL_DEBUG_DEDUPE_TABLE_SIZE 1024 //Must be a power of 2
+
+struct sgl_debug_dedupe_entry {
+    sgl_atomic32 key;           //0 = empty
+    sgl_atomic32 count;
+    sgl_atomic32 last_frame;    //frame + 1, so 0 means never seen
+};
+
+//@NOTE: Bounded multi producer queue (Dmitry Vyukov's), the driver is allowed to call the debug
+//callback from several threads at once when the output is not synchronous.
+struct sgl_debug_ring_slot {
+    sgl_atomic32 sequence;
+    SGLDebugMessage message;
+};
+
+struct sgl_debug_state {
+    bool32 enabled;
+    sgl_atomic32 frame;
+
+    sgl_atomic32 write;
+    sgl_atomic32 read;
+    sgl_debug_ring_slot ring[SGL_DEBUG_RING_SIZE];
+
+    sgl_debug_dedupe_entry dedupe[SGL_DEBUG_DEDUPE_TABLE_SIZE];
+
+    sgl_atomic32 total_messages;
+    sgl_atomic32 unique_messages;
+    sgl_atomic32 error_messages;
+    sgl_atomic32 performance_messages;
+    sgl_atomic32 deprecated_messages;
+    sgl_atomic32 undefined_messages;
+    sgl_atomic32 portability_messages;
+    sgl_atomic32 other_messages;
+    sgl_atomic32 high_severity_messages;
+    sgl_atomic32 ring_pushed;
+    sgl_atomic32 ring_dropped;
+};
+
+global_variable sgl_debug_state sgl_debug;
+
+internal bool32
+sgl_internal_debug_ring_push(GLenum source, GLenum type, GLuint id, GLenum severity,
+                             GLsizei length, const GLchar* text, uint32 frame)
+{
+    LONG position = sgl_debug.write;
+    sgl_debug_ring_slot* slot;
+    for(;;)
+    {
+        slot = &sgl_debug.ring[position & (SGL_DEBUG_RING_SIZE - 1)];
+        LONG diff = slot->sequence - position;
+        if(diff == 0)
+        {
+            if(SGL_AtomicCompareExchange(&sgl_debug.write, position + 1, position) == position)
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            //Full, the reader is behind.
+            SGL_AtomicIncrement(&sgl_debug.ring_dropped);
+            return false;
+        }
+        position = sgl_debug.write;
+    }
+
+    SGLDebugMessage* message = &slot->message;
+    message->frame    = frame;
+    message->source   = source;
+    message->type     = type;
+    message->severity = severity;
+    message->id       = id;
+    GLsizei copy_length = (length < SGL_DEBUG_MESSAGE_MAX - 1) ? length : SGL_DEBUG_MESSAGE_MAX - 1;
+    for(GLsizei index = 0; index < copy_length; ++index)
+    {
+        message->text[index] = text[index];
+    }
+    message->text[copy_length] = 0;
+
+    //Publish, the exchange is a full barrier so the reader sees the message before the sequence.
+    SGL_AtomicExchange(&slot->sequence, position + 1);
+    SGL_AtomicIncrement(&sgl_debug.ring_pushed);
+    return true;
+}
+
+internal void APIENTRY
+sgl_internal_debug_callback(GLenum source, GLenum type, GLuint id, GLenum severity,
+                            GLsizei length, const GLchar* text, const void* user_param)
+{
+    SGL_AtomicIncrement(&sgl_debug.total_messages);
+    switch(type)
+    {
+        case GL_DEBUG_TYPE_ERROR:               SGL_AtomicIncrement(&sgl_debug.error_messages); break;
+        case GL_DEBUG_TYPE_PERFORMANCE:         SGL_AtomicIncrement(&sgl_debug.performance_messages); break;
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: SGL_AtomicIncrement(&sgl_debug.deprecated_messages); break;
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:  SGL_AtomicIncrement(&sgl_debug.undefined_messages); break;
+        case GL_DEBUG_TYPE_PORTABILITY:         SGL_AtomicIncrement(&sgl_debug.portability_messages); break;
+        default:                                SGL_AtomicIncrement(&sgl_debug.other_messages); break;
+    }
+    if(severity == GL_DEBUG_SEVERITY_HIGH)
+    {
+        SGL_AtomicIncrement(&sgl_debug.high_severity_messages);
+    }
+
+    if(length < 0)
+    {
+        length = 0;
+        while(text[length]) ++length;
+    }
+
+    uint32 key = sgl_internal_hash32(&source, sizeof(source));
+    key = sgl_internal_hash32(&type, sizeof(type), key);
+    key = sgl_internal_hash32(&id, sizeof(id), key);
+    key = sgl_internal_hash32(text, length, key);
+    if(!key) key = 1;
+
+    LONG frame_tag = sgl_debug.frame + 1;
+    bool32 first_this_frame = true;
+    for(uint32 probe = 0; probe < SGL_DEBUG_DEDUPE_TABLE_SIZE; ++probe)
+    {
+        sgl_debug_dedupe_entry* entry = &sgl_debug.dedupe[(key + probe) & (SGL_DEBUG_DEDUPE_TABLE_SIZE - 1)];
+        LONG entry_key = entry->key;
+        if(entry_key == 0)
+        {
+            entry_key = SGL_AtomicCompareExchange(&entry->key, key, 0);
+            if(entry_key == 0)
+            {
+                SGL_AtomicIncrement(&sgl_debug.unique_messages);
+                entry_key = (LONG)key;
+            }
+        }
+        if(entry_key == (LONG)key)
+        {
+            SGL_AtomicIncrement(&entry->count);
+            first_this_frame = (SGL_AtomicExchange(&entry->last_frame, frame_tag) != frame_tag);
+            break;
+        }
+        //@NOTE: If the table is full we just don't dedupe anymore.
+    }
+
+    if(type == GL_DEBUG_TYPE_PERFORMANCE && first_this_frame)
+    {
+        sgl_internal_debug_ring_push(source, type, id, severity, length, text, (uint32)(frame_tag - 1));
+    }
+}
+
+bool32
+sgl_debug_output_setup(bool32 synchronous)
+{
+    if(!glDebugMessageCallback || !glDebugMessageControl)
+    {
+        return false;
+    }
+
+    for(LONG index = 0; index < SGL_DEBUG_RING_SIZE; ++index)
+    {
+        sgl_debug.ring[index].sequence = index;
+    }
+    sgl_debug.write = 0;
+    sgl_debug.read  = 0;
+
+    glEnable(GL_DEBUG_OUTPUT);
+    if(synchronous)
+    {
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    else
+    {
+        glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    }
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, 0, GL_TRUE);
+    glDebugMessageCallback(sgl_internal_debug_callback, 0);
+    sgl_debug.enabled = true;
+    return true;
+}
+
+uint32
+sgl_debug_frame_advance()
+{
+    return (uint32)SGL_AtomicIncrement(&sgl_debug.frame);
+}
+
+bool32
+sgl_debug_pop_message(SGLDebugMessage* message)
+{
+    LONG position = sgl_debug.read;
+    sgl_debug_ring_slot* slot = &sgl_debug.ring[position & (SGL_DEBUG_RING_SIZE - 1)];
+    //The exchange-add of 0 is just an acquire load of the sequence.
+    if(SGL_AtomicAdd(&slot->sequence, 0) != position + 1)
+    {
+        return false;
+    }
+    *message = slot->message;
+    SGL_AtomicExchange(&slot->sequence, position + SGL_DEBUG_RING_SIZE);
+    sgl_debug.read = position + 1;
+    return true;
+}
+
+void
+sgl_debug_get_stats(SGLDebugStats* stats)
+{
+    stats->frame                  = (uint32)sgl_debug.frame;
+    stats->total_messages         = (uint32)sgl_debug.total_messages;
+    stats->unique_messages        = (uint32)sgl_debug.unique_messages;
+    stats->error_messages         = (uint32)sgl_debug.error_messages;
+    stats->performance_messages   = (uint32)sgl_debug.performance_messages;
+    stats->deprecated_messages    = (uint32)sgl_debug.deprecated_messages;
+    stats->undefined_messages     = (uint32)sgl_debug.undefined_messages;
+    stats->portability_messages   = (uint32)sgl_debug.portability_messages;
+    stats->other_messages         = (uint32)sgl_debug.other_messages;
+    stats->high_severity_messages = (uint32)sgl_debug.high_severity_messages;
+    stats->ring_pushed            = (uint32)sgl_debug.ring_pushed;
+    stats->ring_dropped           = (uint32)sgl_debug.ring_dropped;
+}
+
+internal void sgl_internal_gpu_memory_label(GLenum identifier, GLuint name, const char* label);
+
+void
+sgl_debug_label(GLenum identifier, GLuint name, const char* label)
+{
+    sgl_internal_gpu_memory_label(identifier, name, label);
+    if(glObjectLabel && label)
+    {
+        glObjectLabel(identifier, name, -1, label);
+    }
+}
+
+//[END Debug Output] ---------------------
+
+//
+//[GPU Memory] ---------------------
+
+#include <stdio.h>
+
+//[INTERNAL]
+struct sgl_gpu_record {
+    GLuint name;
+    int32 category;         //-1 = empty slot
+    uint64 bytes;
+    GLenum format;
+    const char* function;
+    int32 line;
+    char label[32];         //Copied, debug names don't have to outlive the object
+};
+
+//[INTERNAL]
+struct sgl_gpu_memory_state {
+    sgl_gpu_record* records;    //Open addressing on (category, name), allocated on first use
+    SGLGpuMemoryStats stats;
+    bool32 budget_warned;
+};
+global_variable sgl_gpu_memory_state sgl_gpu_memory;
+
+internal void* sgl_internal_alloc(size_t size);
+
+internal uint32
+sgl_internal_gpu_slot(SGLGpuCategory category, GLuint name)
+{
+    return ((name*2654435761u) ^ ((uint32)category*0x9E3779B9u)) & (SGL_GPU_TRACK_CAPACITY - 1);
+}
+
+internal void
+sgl_internal_gpu_copy_label(sgl_gpu_record* record, const char* label)
+{
+    uint32 length = 0;
+    for(; label[length] && length < sizeof(record->label) - 1; ++length)
+    {
+        record->label[length] = label[length];
+    }
+    record->label[length] = 0;
+}
+
+internal sgl_gpu_record*
+sgl_internal_gpu_find(SGLGpuCategory category, GLuint name)
+{
+    uint32 slot = sgl_internal_gpu_slot(category, name);
+    for(uint32 probe = 0; sgl_gpu_memory.records && probe < SGL_GPU_TRACK_CAPACITY;
+        ++probe, slot = (slot + 1) & (SGL_GPU_TRACK_CAPACITY - 1))
+    {
+        sgl_gpu_record* record = &sgl_gpu_memory.records[slot];
+        if(record->category < 0)
+        {
+            return 0;
+        }
+        if(record->category == category && record->name == name)
+        {
+            return record;
+        }
+    }
+    return 0;
+}
+
+//@NOTE: Called by sgl_debug_label so the leak report shows the same names the GL debugger does.
+internal void
+sgl_internal_gpu_memory_label(GLenum identifier, GLuint name, const char* label)
+{
+    SGLGpuCategory category;
+    switch(identifier)
+    {
+        case GL_BUFFER:       category = SGL_GPU_BUFFER;       break;
+        case GL_TEXTURE:      category = SGL_GPU_TEXTURE;      break;
+        case GL_RENDERBUFFER: category = SGL_GPU_RENDERBUFFER; break;
+        case GL_PROGRAM:      category = SGL_GPU_PROGRAM;      break;
+        default: return;
+    }
+    sgl_gpu_record* record = sgl_internal_gpu_find(category, name);
+    if(record && label)
+    {
+        sgl_internal_gpu_copy_label(record, label);
+    }
+}
+
+void
+sgl_gpu_memory_track(SGLGpuCategory category, GLuint name, uint64 bytes, GLenum format, const char* label,
+                     const char* function, int32 line)
+{
+    if(!name)
+    {
+        return;
+    }
+    if(!sgl_gpu_memory.records)
+    {
+        sgl_gpu_memory.records = (sgl_gpu_record*)sgl_internal_alloc(SGL_GPU_TRACK_CAPACITY*sizeof(sgl_gpu_record));
+        if(!sgl_gpu_memory.records)
+        {
+            return;
+        }
+        for(uint32 index = 0; index < SGL_GPU_TRACK_CAPACITY; ++index)
+        {
+            sgl_gpu_memory.records[index].category = -1;
+        }
+    }
+
+    SGLGpuMemoryStats* stats = &sgl_gpu_memory.stats;
+    uint32 slot = sgl_internal_gpu_slot(category, name);
+    sgl_gpu_record* record = 0;
+    for(uint32 probe = 0; probe < SGL_GPU_TRACK_CAPACITY; ++probe, slot = (slot + 1) & (SGL_GPU_TRACK_CAPACITY - 1))
+    {
+        sgl_gpu_record* candidate = &sgl_gpu_memory.records[slot];
+        if(candidate->category < 0 || (candidate->category == category && candidate->name == name))
+        {
+            record = candidate;
+            break;
+        }
+    }
+    if(!record)
+    {
+        ++stats->untracked;
+        return;
+    }
+
+    if(record->category < 0)
+    {
+        //New object. Re-specifying a known one (glBufferData / glTexImage2D again) only changes its size.
+        record->category = category;
+        record->name = name;
+        record->bytes = 0;
+        record->label[0] = 0;
+        record->function = function;
+        record->line = line;
+        ++stats->live_objects[category];
+        if(stats->live_objects[category] > stats->peak_objects[category])
+        {
+            stats->peak_objects[category] = stats->live_objects[category];
+        }
+    }
+    stats->live_bytes[category] += bytes - record->bytes;
+    stats->total_live_bytes     += bytes - record->bytes;
+    record->bytes  = bytes;
+    record->format = format;
+    if(label)
+    {
+        sgl_internal_gpu_copy_label(record, label);
+    }
+    if(stats->live_bytes[category] > stats->peak_bytes[category])
+    {
+        stats->peak_bytes[category] = stats->live_bytes[category];
+    }
+    if(stats->total_live_bytes > stats->total_peak_bytes)
+    {
+        stats->total_peak_bytes = stats->total_live_bytes;
+    }
+    if(stats->budget_bytes && stats->total_live_bytes > stats->budget_bytes && !sgl_gpu_memory.budget_warned)
+    {
+        sgl_gpu_memory.budget_warned = true;
+        fprintf(stderr, "SGL GPU memory over budget : %llu bytes live, budget %llu (%s:%d)\n",
+                (unsigned long long)stats->total_live_bytes, (unsigned long long)stats->budget_bytes, function, line);
+    }
+}
+
+void
+sgl_gpu_memory_untrack(SGLGpuCategory category, GLuint name)
+{
+    if(!name || !sgl_gpu_memory.records)
+    {
+        return;
+    }
+    uint32 mask = SGL_GPU_TRACK_CAPACITY - 1;
+    uint32 slot = sgl_internal_gpu_slot(category, name);
+    for(uint32 probe = 0; probe < SGL_GPU_TRACK_CAPACITY; ++probe, slot = (slot + 1) & mask)
+    {
+        sgl_gpu_record* record = &sgl_gpu_memory.records[slot];
+        if(record->category < 0)
+        {
+            return;
+        }
+        if(record->category != category || record->name != name)
+        {
+            continue;
+        }
+
+        SGLGpuMemoryStats* stats = &sgl_gpu_memory.stats;
+        stats->live_bytes[category] -= record->bytes;
+        stats->total_live_bytes     -= record->bytes;
+        --stats->live_objects[category];
+        if(stats->total_live_bytes <= stats->budget_bytes)
+        {
+            sgl_gpu_memory.budget_warned = false;
+        }
+
+        //Backward shift deletion, keeps the probe chains intact without tombstones.
+        uint32 hole = slot;
+        for(uint32 next = (hole + 1) & mask; sgl_gpu_memory.records[next].category >= 0; next = (next + 1) & mask)
+        {
+            sgl_gpu_record* moving = &sgl_gpu_memory.records[next];
+            uint32 home = sgl_internal_gpu_slot((SGLGpuCategory)moving->category, moving->name);
+            if(((next - home) & mask) >= ((next - hole) & mask))
+            {
+                sgl_gpu_memory.records[hole] = *moving;
+                hole = next;
+            }
+        }
+        sgl_gpu_memory.records[hole].category = -1;
+        return;
+    }
+}
+
+void
+sgl_gpu_memory_reset()
+{
+    uint64 budget_bytes = sgl_gpu_memory.stats.budget_bytes;
+    for(uint32 index = 0; sgl_gpu_memory.records && index < SGL_GPU_TRACK_CAPACITY; ++index)
+    {
+        sgl_gpu_memory.records[index].category = -1;
+    }
+    sgl_gpu_memory.stats = {};
+    sgl_gpu_memory.stats.budget_bytes = budget_bytes;
+    sgl_gpu_memory.budget_warned = false;
+}
+
+void
+sgl_gpu_memory_get_stats(SGLGpuMemoryStats* stats)
+{
+    *stats = sgl_gpu_memory.stats;
+}
+
+void
+sgl_gpu_memory_set_budget(uint64 budget_bytes)
+{
+    sgl_gpu_memory.stats.budget_bytes = budget_bytes;
+    sgl_gpu_memory.budget_warned = false;
+}
+
+uint32
+sgl_gpu_memory_report_leaks()
+{
+    local_persist const char* category_names[SGL_GPU_CATEGORY_COUNT] = {"buffer", "texture", "renderbuffer", "program"};
+    uint32 leaks = 0;
+    for(uint32 index = 0; sgl_gpu_memory.records && index < SGL_GPU_TRACK_CAPACITY; ++index)
+    {
+        sgl_gpu_record* record = &sgl_gpu_memory.records[index];
+        if(record->category < 0)
+        {
+            continue;
+        }
+        if(!leaks)
+        {
+            fprintf(stderr, "SGL GPU memory leaks :\n");
+        }
+        ++leaks;
+        fprintf(stderr, "  %-12s %6u %12llu bytes format 0x%04X  %s  created in %s:%d\n",
+                category_names[record->category], record->name, (unsigned long long)record->bytes, record->format,
+                record->label, record->function, record->line);
+    }
+    if(leaks)
+    {
+        fprintf(stderr, "SGL GPU memory : %u objects, %llu bytes leaked\n", leaks,
+                (unsigned long long)sgl_gpu_memory.stats.total_live_bytes);
+    }
+    if(sgl_gpu_memory.stats.untracked)
+    {
+        fprintf(stderr, "SGL GPU memory : %u objects were never tracked (raise SGL_GPU_TRACK_CAPACITY)\n",
+                sgl_gpu_memory.stats.untracked);
+    }
+    return leaks;
+}
+
+internal uint32
+sgl_internal_format_bytes(GLenum format)
+{
+    switch(format)
+    {
+        case GL_R8:          return 1;
+        case GL_RG8:
+        case GL_R16F:        return 2;
+        case GL_RGBA16F:     return 8;
+        case GL_RGBA32F:     return 16;
+        default:             return 4;
+    }
+}
+
+internal void
+sgl_internal_buffer_delete(GLuint* buffer)
+{
+    sgl_gpu_memory_untrack(SGL_GPU_BUFFER, *buffer);
+    glDeleteBuffers(1, buffer);
+    *buffer = 0;
+}
+
+internal void
+sgl_internal_texture_delete(GLuint* texture)
+{
+    sgl_gpu_memory_untrack(SGL_GPU_TEXTURE, *texture);
+    glDeleteTextures(1, texture);
+    *texture = 0;
+}
+
+internal void
+sgl_internal_program_delete(GLuint* program)
+{
+    sgl_gpu_memory_untrack(SGL_GPU_PROGRAM, *program);
+    glDeleteProgram(*program);
+    *program = 0;
+}
+
+//[END GPU Memory] ---------------------
+
+//
+//[Shaders] ---------------------
+
+GLuint
+sgl_internal_shader_create(GLenum shader_type,const char* shader_file)
+{
+    GLuint shader = glCreateShader(shader_type);
+    glShaderSource(shader, 1,&shader_file, NULL);
+    glCompileShader(shader);
+    
+    GLint status;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        GLint info_log_length;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &info_log_length);
+
+        //TODO(filipe): Get rid of this new...
+        GLchar *info_log = new GLchar[info_log_length + 1];
+        glGetShaderInfoLog(shader, info_log_length, NULL, info_log);
+
+        const char *string_shader_type = NULL;
+        switch(shader_type)
+        {
+            case GL_VERTEX_SHADER:   string_shader_type = "vertex"; break;
+            case GL_GEOMETRY_SHADER: string_shader_type = "geometry"; break;
+            case GL_FRAGMENT_SHADER: string_shader_type = "fragment"; break;
+            case GL_COMPUTE_SHADER:  string_shader_type = "compute"; break;
+        }
+        fprintf(stderr, "Compile failure in %s shader:\n%s\n",
+                string_shader_type, info_log);
+        
+        delete(info_log);
+    }
+    return shader;
+}
+
+//@NOTE: Tracked under the caller's function/line, see [GPU Memory].
+#define sgl_internal_program_create(shader_list, size, debug_name) \
+    sgl_internal_program_create_at(shader_list, size, debug_name, __FUNCTION__, __LINE__)
+
+GLuint
+sgl_internal_program_create_at(GLuint* shader_list, int size, char* debug_name, const char* function, int32 line)
+{
+    GLuint program = glCreateProgram();
+    sgl_gpu_memory_track(SGL_GPU_PROGRAM, program, 0, 0, debug_name, function, line);
+    
+    for(size_t index = 0; index < size; ++index)
+    {
+        glAttachShader(program, shader_list[index]);
+    }
+    glLinkProgram(program);
+
+    GLint status;
+    glGetProgramiv (program, GL_LINK_STATUS, &status);
+    if (status == GL_FALSE)
+    {
+        GLint info_log_length;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &info_log_length);
+
+        GLchar *string_info_log = new GLchar[info_log_length + 1];
+        glGetProgramInfoLog(program, info_log_length, NULL, string_info_log);
+            
+        fprintf(stderr, "Linker failure in Program [%s]: %s\n",debug_name,  string_info_log);
+
+        delete(string_info_log);
+    }
+    for(size_t index = 0; index < size; ++index)
+    {
+        glDetachShader(program, shader_list[index]);
+    }
+    sgl_debug_label(GL_PROGRAM, program, debug_name);
+    return program;
+}
+
+//[END Shaders] ---------------------
+
+//
+//[Memory] ---------------------
+
+//@NOTE: Page aligned and zeroed.
+internal void*
+sgl_internal_alloc(size_t size)
+{
+#ifdef _WIN32
+    return VirtualAlloc(0, size, MEM_RESERVE|MEM_COMMIT, PAGE_READWRITE);
+#else
+    //@TODO: Other OS
+   #error No other OS defined!
+#endif //_WIN32
+}
+
+internal void
+sgl_internal_free(void* memory)
+{
+#ifdef _WIN32
+    if(memory)
+    {
+        VirtualFree(memory, 0, MEM_RELEASE);
+    }
+#else
+    //@TODO: Other OS
+   #error No other OS defined!
+#endif //_WIN32
+}
+
+#define SGL_AlignPow2(value, alignment) (((value) + ((alignment) - 1)) & ~((alignment) - 1))
+
+#ifdef _MSC_VER
+#define SGL_ALIGN16 __declspec(align(16))
+#else
+#define SGL_ALIGN16 __attribute__((aligned(16)))
+#endif
+
+internal uint32
+sgl_internal_bit_scan_forward(uint32 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (uint32)index;
+#else
+    return (uint32)__builtin_ctz(value);
+#endif
+}
+
+//[END Memory] ---------------------
+
+//
+//[Thread Pool] ---------------------
+
+#ifdef _WIN32
+
+//@NOTE: next_job holds the run generation in its top bits and the job index in the low ones, so every
+//claim says which run it was taken from. A worker can claim an index and stall past the end of its run;
+//without the generation that index could pass the next run's (bigger) job_count and run a job twice.
+//The index part only ever overshoots job_count by one claim per wake, the headroom above
+//SGL_THREAD_POOL_MAX_JOBS keeps it from carrying into the generation.
+#define SGL_THREAD_POOL_INDEX_BITS 20
+#define SGL_THREAD_POOL_INDEX_MASK ((1u << SGL_THREAD_POOL_INDEX_BITS) - 1)
+
+internal bool32
+sgl_internal_thread_pool_work(SGLThreadPool* pool)
+{
+    bool32 did_work = false;
+    for(;;)
+    {
+        uint32 claim = (uint32)(SGL_AtomicIncrement(&pool->next_job) - 1);
+        uint32 job_index = claim & SGL_THREAD_POOL_INDEX_MASK;
+        uint32 generation = claim >> SGL_THREAD_POOL_INDEX_BITS;
+
+        //Run state first, generation last. sgl_thread_pool_run bumps the generation before touching the
+        //rest, so if it still matches here what we read belongs to the run the claim came from.
+        uint32 job_count = (uint32)SGL_AtomicAdd(&pool->job_count, 0);
+        sgl_job_func* func = pool->func;
+        void* data = pool->data;
+        uint32 current = (uint32)SGL_AtomicAdd(&pool->generation, 0) & (0xFFFFFFFFu >> SGL_THREAD_POOL_INDEX_BITS);
+        if(generation != current || job_index >= job_count)
+        {
+            break;
+        }
+        func(data, job_index);
+        did_work = true;
+        if((uint32)SGL_AtomicIncrement(&pool->jobs_done) == job_count)
+        {
+            SetEvent(pool->done_event);
+        }
+    }
+    return did_work;
+}
+
+internal DWORD WINAPI
+sgl_internal_thread_pool_proc(void* parameter)
+{
+    SGLThreadPool* pool = (SGLThreadPool*)parameter;
+    for(;;)
+    {
+        WaitForSingleObject(pool->work_semaphore, INFINITE);
+        if(pool->quit)
+        {
+            break;
+        }
+        sgl_internal_thread_pool_work(pool);
+    }
+    return 0;
+}
+
+bool32
+sgl_thread_pool_create(SGLThreadPool* pool, int32 thread_count)
+{
+    *pool = {};
+    if(thread_count <= 0)
+    {
+        SYSTEM_INFO system_info;
+        GetSystemInfo(&system_info);
+        thread_count = (int32)system_info.dwNumberOfProcessors - 1;
+    }
+    if(thread_count > SGL_MAX_THREADS)
+    {
+        thread_count = SGL_MAX_THREADS;
+    }
+
+    pool->work_semaphore = CreateSemaphoreA(0, 0, 0x7FFFFFFF, 0);
+    pool->done_event = CreateEventA(0, FALSE, FALSE, 0);
+    if(!pool->work_semaphore || !pool->done_event)
+    {
+        return false;
+    }
+    for(int32 index = 0; index < thread_count; ++index)
+    {
+        HANDLE thread = CreateThread(0, 0, sgl_internal_thread_pool_proc, pool, 0, 0);
+        if(!thread)
+        {
+            break;
+        }
+        pool->threads[pool->thread_count++] = thread;
+    }
+    return true;
+}
+
+void
+sgl_thread_pool_run(SGLThreadPool* pool, uint32 job_count, sgl_job_func* func, void* data)
+{
+    if(!job_count)
+    {
+        return;
+    }
+    if(!pool || !pool->thread_count || job_count == 1)
+    {
+        for(uint32 index = 0; index < job_count; ++index)
+        {
+            func(data, index);
+        }
+        return;
+    }
+
+    SGL_Assert(job_count < SGL_THREAD_POOL_MAX_JOBS);
+    //New generation before anything else (see sgl_internal_thread_pool_work), claims from the last run
+    //now fail whatever job_count they end up reading.
+    uint32 generation = (uint32)SGL_AtomicIncrement(&pool->generation) & (0xFFFFFFFFu >> SGL_THREAD_POOL_INDEX_BITS);
+    pool->func = func;
+    pool->data = data;
+    SGL_AtomicExchange(&pool->jobs_done, 0);
+    SGL_AtomicExchange(&pool->job_count, job_count);
+    SGL_AtomicExchange(&pool->next_job, generation << SGL_THREAD_POOL_INDEX_BITS);
+
+    LONG wake_count = ((int32)job_count - 1 < pool->thread_count) ? (LONG)job_count - 1 : pool->thread_count;
+    ReleaseSemaphore(pool->work_semaphore, wake_count, 0);
+
+    sgl_internal_thread_pool_work(pool);
+    //@NOTE: Whoever finishes the last job signals the event exactly once per run, so always wait on it
+    //(even if we did the last job ourselves) or it would stay signalled into the next run.
+    WaitForSingleObject(pool->done_event, INFINITE);
+}
+
+void
+sgl_thread_pool_destroy(SGLThreadPool* pool)
+{
+    SGL_AtomicExchange(&pool->quit, 1);
+    ReleaseSemaphore(pool->work_semaphore, pool->thread_count, 0);
+    if(pool->thread_count)
+    {
+        WaitForMultipleObjects(pool->thread_count, pool->threads, TRUE, INFINITE);
+    }
+    for(int32 index = 0; index < pool->thread_count; ++index)
+    {
+        CloseHandle(pool->threads[index]);
+    }
+    CloseHandle(pool->work_semaphore);
+    CloseHandle(pool->done_event);
+    *pool = {};
+}
+
+#else
+    //@TODO: Other OS
+   #error No other OS defined!
+#endif //_WIN32
+
+//[END Thread Pool] ---------------------
+
+//
+//[Frustum Culling] ---------------------
+
+#include <math.h>
+
+bool32
+sgl_cull_objects_create(SGLCullObjects* objects, uint32 capacity)
+{
+    *objects = {};
+    uint32 padded = SGL_AlignPow2(capacity, 8);
+    size_t float_array_size = padded*sizeof(float);
+    size_t size = 7*float_array_size + padded*sizeof(uint32) + padded*SGL_CULL_MAX_LODS*sizeof(SGLCullLod);
+    uint8* memory = (uint8*)sgl_internal_alloc(size);
+    if(!memory)
+    {
+        return false;
+    }
+    objects->capacity = capacity;
+    objects->center_x  = (float*)memory; memory += float_array_size;
+    objects->center_y  = (float*)memory; memory += float_array_size;
+    objects->center_z  = (float*)memory; memory += float_array_size;
+    objects->extent_x  = (float*)memory; memory += float_array_size;
+    objects->extent_y  = (float*)memory; memory += float_array_size;
+    objects->extent_z  = (float*)memory; memory += float_array_size;
+    objects->radius    = (float*)memory; memory += float_array_size;
+    objects->lod_count = (uint32*)memory; memory += padded*sizeof(uint32);
+    objects->lods      = (SGLCullLod*)memory;
+    return true;
+}
+
+void
+sgl_cull_objects_free(SGLCullObjects* objects)
+{
+    sgl_internal_free(objects->center_x);
+    *objects = {};
+}
+
+uint32
+sgl_cull_object_add(SGLCullObjects* objects, float center_x, float center_y, float center_z,
+                    float extent_x, float extent_y, float extent_z,
+                    SGLCullLod* lods, uint32 lod_count)
+{
+    SGL_Assert(objects->count < objects->capacity);
+    SGL_Assert(lod_count > 0 && lod_count <= SGL_CULL_MAX_LODS);
+
+    uint32 index = objects->count++;
+    objects->center_x[index] = center_x;
+    objects->center_y[index] = center_y;
+    objects->center_z[index] = center_z;
+    objects->extent_x[index] = extent_x;
+    objects->extent_y[index] = extent_y;
+    objects->extent_z[index] = extent_z;
+    objects->radius[index]   = sqrtf(extent_x*extent_x + extent_y*extent_y + extent_z*extent_z);
+    objects->lod_count[index] = lod_count;
+    for(uint32 lod = 0; lod < lod_count; ++lod)
+    {
+        objects->lods[index*SGL_CULL_MAX_LODS + lod] = lods[lod];
+    }
+    return index;
+}
+
+uint32
+sgl_cull_object_add_sphere(SGLCullObjects* objects, float center_x, float center_y, float center_z,
+                           float radius, SGLCullLod* lods, uint32 lod_count)
+{
+    uint32 index = sgl_cull_object_add(objects, center_x, center_y, center_z, radius, radius, radius, lods, lod_count);
+    objects->radius[index] = radius;
+    return index;
+}
+
+bool32
+sgl_draw_list_create(SGLDrawList* list, uint32 capacity)
+{
+    *list = {};
+    size_t size = capacity*(sizeof(GLsizei) + sizeof(void*) + sizeof(uint32) + sizeof(uint8));
+    uint8* memory = (uint8*)sgl_internal_alloc(size);
+    if(!memory)
+    {
+        return false;
+    }
+    list->capacity = capacity;
+    list->index_offsets  = (const void**)memory; memory += capacity*sizeof(void*);
+    list->index_counts   = (GLsizei*)memory;     memory += capacity*sizeof(GLsizei);
+    list->object_indices = (uint32*)memory;      memory += capacity*sizeof(uint32);
+    list->lods           = (uint8*)memory;
+    return true;
+}
+
+void
+sgl_draw_list_free(SGLDrawList* list)
+{
+    sgl_internal_free((void*)list->index_offsets);
+    *list = {};
+}
+
+void
+sgl_frustum_from_matrix(SGLFrustum* frustum, const float* m, const float* camera, float projection_scale)
+{
+    //@NOTE: Gribb/Hartmann, rows of the column major matrix are m[row + col*4].
+    float rows[4][4];
+    for(int32 row = 0; row < 4; ++row)
+    {
+        for(int32 col = 0; col < 4; ++col)
+        {
+            rows[row][col] = m[row + col*4];
+        }
+    }
+    for(int32 plane = 0; plane < 6; ++plane)
+    {
+        int32 row = plane / 2;
+        float sign = (plane & 1) ? -1.0f : 1.0f;
+        float x = rows[3][0] + sign*rows[row][0];
+        float y = rows[3][1] + sign*rows[row][1];
+        float z = rows[3][2] + sign*rows[row][2];
+        float w = rows[3][3] + sign*rows[row][3];
+        float length = sqrtf(x*x + y*y + z*z);
+        float inv_length = (length > 0.0f) ? 1.0f / length : 0.0f;
+        frustum->plane_x[plane] = x*inv_length;
+        frustum->plane_y[plane] = y*inv_length;
+        frustum->plane_z[plane] = z*inv_length;
+        frustum->plane_w[plane] = w*inv_length;
+    }
+    frustum->camera[0] = camera[0];
+    frustum->camera[1] = camera[1];
+    frustum->camera[2] = camera[2];
+    frustum->lod_scale = projection_scale;
+    float threshold = 0.25f;
+    for(int32 lod = 0; lod < SGL_CULL_MAX_LODS - 1; ++lod)
+    {
+        frustum->lod_thresholds[lod] = threshold;
+        threshold *= 0.4f;
+    }
+}
+
+internal inline void
+sgl_internal_cull_emit(SGLCullObjects* objects, SGLFrustum* frustum, SGLDrawList* list,
+                       uint32 object_index, uint32 out_index)
+{
+    float dx = objects->center_x[object_index] - frustum->camera[0];
+    float dy = objects->center_y[object_index] - frustum->camera[1];
+    float dz = objects->center_z[object_index] - frustum->camera[2];
+    float distance = sqrtf(dx*dx + dy*dy + dz*dz);
+    float projected_size = objects->radius[object_index]*frustum->lod_scale / ((distance > 1e-4f) ? distance : 1e-4f);
+
+    uint32 lod = 0;
+    uint32 lod_count = objects->lod_count[object_index];
+    while(lod + 1 < lod_count && projected_size < frustum->lod_thresholds[lod])
+    {
+        ++lod;
+    }
+
+    SGLCullLod* chosen = &objects->lods[object_index*SGL_CULL_MAX_LODS + lod];
+    list->index_counts[out_index]   = chosen->index_count;
+    list->index_offsets[out_index]  = (const void*)(size_t)chosen->index_offset;
+    list->object_indices[out_index] = object_index;
+    list->lods[out_index]           = (uint8)lod;
+}
+
+//@NOTE: Culls [first, one_past_last) and writes the visible ones starting at out_first.
+//first must be a multiple of 8. Returns how many were written.
+internal uint32
+sgl_internal_cull_range(SGLCullObjects* objects, SGLFrustum* frustum, SGLDrawList* list,
+                        uint32 first, uint32 one_past_last, uint32 out_first)
+{
+    uint32 out_index = out_first;
+    uint32 index = first;
+
+#if SGL_AVX2
+    __m256 abs_mask8 = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    __m256 zero8 = _mm256_setzero_ps();
+    for(; index < one_past_last; index += 8)
+    {
+        __m256 cx = _mm256_load_ps(objects->center_x + index);
+        __m256 cy = _mm256_load_ps(objects->center_y + index);
+        __m256 cz = _mm256_load_ps(objects->center_z + index);
+        __m256 ex = _mm256_load_ps(objects->extent_x + index);
+        __m256 ey = _mm256_load_ps(objects->extent_y + index);
+        __m256 ez = _mm256_load_ps(objects->extent_z + index);
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for(int32 plane = 0; plane < 6; ++plane)
+        {
+            __m256 nx = _mm256_set1_ps(frustum->plane_x[plane]);
+            __m256 ny = _mm256_set1_ps(frustum->plane_y[plane]);
+            __m256 nz = _mm256_set1_ps(frustum->plane_z[plane]);
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, nx), _mm256_mul_ps(cy, ny)),
+                                            _mm256_add_ps(_mm256_mul_ps(cz, nz), _mm256_set1_ps(frustum->plane_w[plane])));
+            __m256 extent = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_and_ps(nx, abs_mask8)),
+                                                        _mm256_mul_ps(ey, _mm256_and_ps(ny, abs_mask8))),
+                                          _mm256_mul_ps(ez, _mm256_and_ps(nz, abs_mask8)));
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, extent), zero8, _CMP_GE_OQ));
+        }
+        uint32 mask = (uint32)_mm256_movemask_ps(visible);
+        if(one_past_last - index < 8)
+        {
+            mask &= (1u << (one_past_last - index)) - 1;
+        }
+        while(mask)
+        {
+            uint32 bit = sgl_internal_bit_scan_forward(mask);
+            mask &= mask - 1;
+            sgl_internal_cull_emit(objects, frustum, list, index + bit, out_index++);
+        }
+    }
+#elif SGL_SSE2
+    __m128 abs_mask4 = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    __m128 zero4 = _mm_setzero_ps();
+    for(; index < one_past_last; index += 4)
+    {
+        __m128 cx = _mm_load_ps(objects->center_x + index);
+        __m128 cy = _mm_load_ps(objects->center_y + index);
+        __m128 cz = _mm_load_ps(objects->center_z + index);
+        __m128 ex = _mm_load_ps(objects->extent_x + index);
+        __m128 ey = _mm_load_ps(objects->extent_y + index);
+        __m128 ez = _mm_load_ps(objects->extent_z + index);
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for(int32 plane = 0; plane < 6; ++plane)
+        {
+            __m128 nx = _mm_set1_ps(frustum->plane_x[plane]);
+            __m128 ny = _mm_set1_ps(frustum->plane_y[plane]);
+            __m128 nz = _mm_set1_ps(frustum->plane_z[plane]);
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, nx), _mm_mul_ps(cy, ny)),
+                                         _mm_add_ps(_mm_mul_ps(cz, nz), _mm_set1_ps(frustum->plane_w[plane])));
+            __m128 extent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_and_ps(nx, abs_mask4)),
+                                                  _mm_mul_ps(ey, _mm_and_ps(ny, abs_mask4))),
+                                       _mm_mul_ps(ez, _mm_and_ps(nz, abs_mask4)));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, extent), zero4));
+        }
+        uint32 mask = (uint32)_mm_movemask_ps(visible);
+        if(one_past_last - index < 4)
+        {
+            mask &= (1u << (one_past_last - index)) - 1;
+        }
+        while(mask)
+        {
+            uint32 bit = sgl_internal_bit_scan_forward(mask);
+            mask &= mask - 1;
+            sgl_internal_cull_emit(objects, frustum, list, index + bit, out_index++);
+        }
+    }
+#endif
+
+    //Scalar fallback (SGL_NO_SIMD)
+    for(; index < one_past_last; ++index)
+    {
+        bool32 visible = true;
+        for(int32 plane = 0; plane < 6 && visible; ++plane)
+        {
+            float nx = frustum->plane_x[plane];
+            float ny = frustum->plane_y[plane];
+            float nz = frustum->plane_z[plane];
+            float distance = objects->center_x[index]*nx + objects->center_y[index]*ny +
+                             objects->center_z[index]*nz + frustum->plane_w[plane];
+            float extent = objects->extent_x[index]*fabsf(nx) + objects->extent_y[index]*fabsf(ny) +
+                           objects->extent_z[index]*fabsf(nz);
+            visible = (distance + extent >= 0.0f);
+        }
+        if(visible)
+        {
+            sgl_internal_cull_emit(objects, frustum, list, index, out_index++);
+        }
+    }
+
+    return out_index - out_first;
+}
+
+#define SGL_CULL_MAX_JOBS 256
+#define SGL_CULL_MIN_JOB_SIZE 16384
+
+struct sgl_cull_job_data {
+    SGLCullObjects* objects;
+    SGLFrustum* frustum;
+    SGLDrawList* list;
+    uint32 job_size;
+    uint32 visible_counts[SGL_CULL_MAX_JOBS];
+};
+
+internal void
+sgl_internal_cull_job(void* data, uint32 job_index)
+{
+    sgl_cull_job_data* job = (sgl_cull_job_data*)data;
+    uint32 first = job_index*job->job_size;
+    uint32 one_past_last = first + job->job_size;
+    if(one_past_last > job->objects->count)
+    {
+        one_past_last = job->objects->count;
+    }
+    //Every job writes at its own first index, there is always room since visible <= job size.
+    job->visible_counts[job_index] = sgl_internal_cull_range(job->objects, job->frustum, job->list,
+                                                             first, one_past_last, first);
+}
+
+void
+sgl_cull(SGLCullObjects* objects, SGLFrustum* frustum, SGLDrawList* list, SGLThreadPool* pool)
+{
+    SGL_Assert(list->capacity >= objects->count);
+    if(!pool || !pool->thread_count || objects->count <= SGL_CULL_MIN_JOB_SIZE)
+    {
+        list->count = sgl_internal_cull_range(objects, frustum, list, 0, objects->count, 0);
+        return;
+    }
+
+    sgl_cull_job_data job;
+    job.objects = objects;
+    job.frustum = frustum;
+    job.list    = list;
+    job.job_size = SGL_AlignPow2((objects->count + SGL_CULL_MAX_JOBS - 1) / SGL_CULL_MAX_JOBS, 8);
+    if(job.job_size < SGL_CULL_MIN_JOB_SIZE)
+    {
+        job.job_size = SGL_CULL_MIN_JOB_SIZE;
+    }
+    uint32 job_count = (objects->count + job.job_size - 1) / job.job_size;
+    sgl_thread_pool_run(pool, job_count, sgl_internal_cull_job, &job);
+
+    //Compact the per job runs.
+    uint32 count = job.visible_counts[0];
+    for(uint32 job_index = 1; job_index < job_count; ++job_index)
+    {
+        uint32 source = job_index*job.job_size;
+        uint32 visible = job.visible_counts[job_index];
+        for(uint32 index = 0; index < visible; ++index)
+        {
+            list->index_counts[count + index]   = list->index_counts[source + index];
+            list->index_offsets[count + index]  = list->index_offsets[source + index];
+            list->object_indices[count + index] = list->object_indices[source + index];
+            list->lods[count + index]           = list->lods[source + index];
+        }
+        count += visible;
+    }
+    list->count = count;
+}
+
+void
+sgl_draw_list_submit(SGLDrawList* list, GLenum mode, GLenum type)
+{
+    if(list->count)
+    {
+        glMultiDrawElements(mode, list->index_counts, type, list->index_offsets, (GLsizei)list->count);
+    }
+}
+
+//[END Frustum Culling] ---------------------
+
+//
+//[Occlusion Culling] ---------------------
+
+char* sgl_occlusion_vertex_shader =
+ "#version 330                                                      \n"
+ "//Occlusion proxy VERT                                            \n"
+ "layout (location = 0) in vec3 position;                           \n"
+ "uniform mat4 view_projection;                                     \n"
+ "uniform vec3 center;                                              \n"
+ "uniform vec3 extent;                                              \n"
+ "void main()                                                       \n"
+ "{                                                                 \n"
+ "    gl_Position = view_projection*vec4(center + position*extent, 1.0); \n"
+ "}                                                                 \n";
+
+char* sgl_occlusion_frag_shader =
+ "#version 330                    \n"
+ "//Occlusion proxy FRAG          \n"
+ "out vec4 color;                 \n"
+ "void main()                     \n"
+ "{                               \n"
+ "    color = vec4(1.0);          \n"
+ "}                               \n";
+
+bool32
+sgl_occlusion_create(SGLOcclusion* occlusion, uint32 capacity)
+{
+    *occlusion = {};
+    occlusion->objects = (SGLOcclusionObject*)sgl_internal_alloc(capacity*sizeof(SGLOcclusionObject));
+    if(!occlusion->objects)
+    {
+        return false;
+    }
+    occlusion->capacity = capacity;
+    occlusion->visible_retest_interval = 4;
+    occlusion->render_mode = GL_QUERY_WAIT;
+
+    //@NOTE: The conservative query lets the driver skip the exact sample count, only 4.3+ has it.
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    occlusion->query_target = (major > 4 || (major == 4 && minor >= 3)) ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+
+    GLuint shader_list[2] = 
+    {
+        sgl_internal_shader_create(GL_VERTEX_SHADER, sgl_occlusion_vertex_shader),
+        sgl_internal_shader_create(GL_FRAGMENT_SHADER, sgl_occlusion_frag_shader)
+    };
+    occlusion->program = sgl_internal_program_create(shader_list, 2, "SGL Occlusion Proxy");
+    glDeleteShader(shader_list[0]);
+    glDeleteShader(shader_list[1]);
+    occlusion->view_projection_location = glGetUniformLocation(occlusion->program, "view_projection");
+    occlusion->center_location          = glGetUniformLocation(occlusion->program, "center");
+    occlusion->extent_location          = glGetUniformLocation(occlusion->program, "extent");
+
+    //Unit cube, scaled by the object's extent in the shader.
+    const GLfloat cube_positions[] =
+    {
+        -1.0f, -1.0f, -1.0f,   1.0f, -1.0f, -1.0f,   1.0f,  1.0f, -1.0f,  -1.0f,  1.0f, -1.0f,
+        -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f,   1.0f,  1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,
+    };
+    const uint8 cube_indices[] =
+    {
+        0, 2, 1,  0, 3, 2,  4, 5, 6,  4, 6, 7,
+        0, 1, 5,  0, 5, 4,  3, 7, 6,  3, 6, 2,
+        0, 4, 7,  0, 7, 3,  1, 2, 6,  1, 6, 5,
+    };
+    glGenVertexArrays(1, &occlusion->vertex_array);
+    glBindVertexArray(occlusion->vertex_array);
+    glGenBuffers(1, &occlusion->vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, occlusion->vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(cube_positions), cube_positions, GL_STATIC_DRAW);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, occlusion->vertex_buffer, sizeof(cube_positions), 0, "SGL Occlusion Vertices");
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
+    glGenBuffers(1, &occlusion->index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, occlusion->index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(cube_indices), cube_indices, GL_STATIC_DRAW);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, occlusion->index_buffer, sizeof(cube_indices), 0, "SGL Occlusion Indices");
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    sgl_debug_label(GL_VERTEX_ARRAY, occlusion->vertex_array, "SGL Occlusion Proxy");
+
+    return true;
+}
+
+void
+sgl_occlusion_free(SGLOcclusion* occlusion)
+{
+    for(uint32 index = 0; index < occlusion->count; ++index)
+    {
+        glDeleteQueries(1, &occlusion->objects[index].query);
+    }
+    sgl_internal_program_delete(&occlusion->program);
+    glDeleteVertexArrays(1, &occlusion->vertex_array);
+    sgl_internal_buffer_delete(&occlusion->vertex_buffer);
+    sgl_internal_buffer_delete(&occlusion->index_buffer);
+    sgl_internal_free(occlusion->objects);
+    *occlusion = {};
+}
+
+void
+sgl_occlusion_object_set_bounds(SGLOcclusion* occlusion, uint32 index, float center_x, float center_y, float center_z,
+                                float extent_x, float extent_y, float extent_z)
+{
+    SGLOcclusionObject* object = &occlusion->objects[index];
+    object->center[0] = center_x;
+    object->center[1] = center_y;
+    object->center[2] = center_z;
+    object->extent[0] = extent_x;
+    object->extent[1] = extent_y;
+    object->extent[2] = extent_z;
+}
+
+uint32
+sgl_occlusion_object_add(SGLOcclusion* occlusion, float center_x, float center_y, float center_z,
+                         float extent_x, float extent_y, float extent_z)
+{
+    SGL_Assert(occlusion->count < occlusion->capacity);
+    uint32 index = occlusion->count++;
+    SGLOcclusionObject* object = &occlusion->objects[index];
+    *object = {};
+    object->visible = true;
+    glGenQueries(1, &object->query);
+    sgl_occlusion_object_set_bounds(occlusion, index, center_x, center_y, center_z, extent_x, extent_y, extent_z);
+    return index;
+}
+
+void
+sgl_occlusion_begin_frame(SGLOcclusion* occlusion, const float* view_projection, const float* camera)
+{
+    ++occlusion->frame;
+    for(int32 index = 0; index < 16; ++index)
+    {
+        occlusion->view_projection[index] = view_projection[index];
+    }
+    occlusion->camera[0] = camera[0];
+    occlusion->camera[1] = camera[1];
+    occlusion->camera[2] = camera[2];
+    occlusion->queries_issued    = 0;
+    occlusion->draws_skipped     = 0;
+    occlusion->draws_conditional = 0;
+
+    for(uint32 index = 0; index < occlusion->count; ++index)
+    {
+        SGLOcclusionObject* object = &occlusion->objects[index];
+        if(object->query_pending)
+        {
+            //@NOTE: Never ask for GL_QUERY_RESULT before it's available, that would stall the CPU.
+            GLuint available = GL_FALSE;
+            glGetQueryObjectuiv(object->query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if(available)
+            {
+                GLuint any_samples = GL_FALSE;
+                glGetQueryObjectuiv(object->query, GL_QUERY_RESULT, &any_samples);
+                object->visible = (any_samples != GL_FALSE);
+                object->query_pending = false;
+            }
+        }
+    }
+}
+
+internal bool32
+sgl_internal_occlusion_camera_inside(SGLOcclusion* occlusion, SGLOcclusionObject* object)
+{
+    //@NOTE: A box the camera is in gets clipped by the near plane and would come back as occluded.
+    //Pad a bit for the near plane distance.
+    const float padding = 0.1f;
+    for(int32 axis = 0; axis < 3; ++axis)
+    {
+        float distance = occlusion->camera[axis] - object->center[axis];
+        if(distance < 0.0f) distance = -distance;
+        if(distance > object->extent[axis] + padding)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+sgl_occlusion_issue_queries(SGLOcclusion* occlusion)
+{
+    GLboolean color_mask[4];
+    GLboolean depth_mask;
+    glGetBooleanv(GL_COLOR_WRITEMASK, color_mask);
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &depth_mask);
+    GLboolean cull_face  = glIsEnabled(GL_CULL_FACE);
+    GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+    GLint program;
+    GLint vertex_array;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &vertex_array);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glDepthMask(GL_FALSE);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+
+    glUseProgram(occlusion->program);
+    glUniformMatrix4fv(occlusion->view_projection_location, 1, GL_FALSE, occlusion->view_projection);
+    glBindVertexArray(occlusion->vertex_array);
+
+    uint32 interval = occlusion->visible_retest_interval ? occlusion->visible_retest_interval : 1;
+    for(uint32 index = 0; index < occlusion->count; ++index)
+    {
+        SGLOcclusionObject* object = &occlusion->objects[index];
+        if(object->query_pending)
+        {
+            continue;
+        }
+        if(sgl_internal_occlusion_camera_inside(occlusion, object))
+        {
+            object->visible = true;
+            continue;
+        }
+        //Visible objects are re-tested every few frames, staggered by index so the cost is spread out.
+        if(object->visible && ((occlusion->frame + index) % interval) != 0)
+        {
+            continue;
+        }
+
+        glUniform3fv(occlusion->center_location, 1, object->center);
+        glUniform3fv(occlusion->extent_location, 1, object->extent);
+        glBeginQuery(occlusion->query_target, object->query);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, 0);
+        glEndQuery(occlusion->query_target);
+
+        object->query_pending = true;
+        object->last_tested_frame = occlusion->frame;
+        ++occlusion->queries_issued;
+    }
+
+    glBindVertexArray((GLuint)vertex_array);
+    glUseProgram((GLuint)program);
+    glColorMask(color_mask[0], color_mask[1], color_mask[2], color_mask[3]);
+    glDepthMask(depth_mask);
+    if(cull_face)   glEnable(GL_CULL_FACE);
+    if(!depth_test) glDisable(GL_DEPTH_TEST);
+}
+
+bool32
+sgl_occlusion_begin_draw(SGLOcclusion* occlusion, uint32 index)
+{
+    SGLOcclusionObject* object = &occlusion->objects[index];
+    object->conditional = false;
+    if(object->query_pending)
+    {
+        //The GPU decides with the latest query we gave it.
+        glBeginConditionalRender(object->query, occlusion->render_mode);
+        object->conditional = true;
+        ++occlusion->draws_conditional;
+        return true;
+    }
+    if(!object->visible)
+    {
+        ++occlusion->draws_skipped;
+        return false;
+    }
+    return true;
+}
+
+void
+sgl_occlusion_end_draw(SGLOcclusion* occlusion, uint32 index)
+{
+    SGLOcclusionObject* object = &occlusion->objects[index];
+    if(object->conditional)
+    {
+        glEndConditionalRender();
+        object->conditional = false;
+    }
+}
+
+//[END Occlusion Culling] ---------------------
+
+//
+//[Binary Meshes] ---------------------
+
+#include <string.h>
+
+internal bool32
+sgl_internal_mesh_blob_valid(SGLMeshFile* file, uint64 offset, uint64 size)
+{
+    return (offset % SGL_MESH_ALIGNMENT) == 0 && offset <= file->size && size <= file->size - offset;
+}
+
+internal bool32
+sgl_internal_mesh_range_valid(uint32 first_index, uint32 index_count, uint32 total_index_count)
+{
+    return first_index <= total_index_count && index_count <= total_index_count - first_index;
+}
+
+//@NOTE: Bytes the attribute takes inside a vertex, 0 for a type we never write (the file is rejected).
+internal uint32
+sgl_internal_mesh_attribute_size(SGLMeshAttribute* attribute)
+{
+    switch(attribute->type)
+    {
+        case GL_INT_2_10_10_10_REV: return attribute->components == 4 ? 4 : 0;
+        case GL_FLOAT:              return attribute->components*4;
+        case GL_HALF_FLOAT:
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:     return attribute->components*2;
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:      return attribute->components;
+        default:                    return 0;
+    }
+}
+
+bool32
+sgl_mesh_file_open(SGLMeshFile* file, const char* path)
+{
+    *file = {};
+#ifdef _WIN32
+    file->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, 0);
+    if(file->file == INVALID_HANDLE_VALUE)
+    {
+        file->file = 0;
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if(GetFileSizeEx(file->file, &file_size) && file_size.QuadPart >= (LONGLONG)sizeof(SGLMeshHeader))
+    {
+        file->size = (uint64)file_size.QuadPart;
+        file->mapping = CreateFileMappingA(file->file, 0, PAGE_READONLY, 0, 0, 0);
+        if(file->mapping)
+        {
+            file->data = (uint8*)MapViewOfFile(file->mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+#else
+    //@TODO: Other OS (mmap)
+   #error No other OS defined!
+#endif //_WIN32
+    if(!file->data)
+    {
+        sgl_mesh_file_close(file);
+        return false;
+    }
+
+    SGLMeshHeader* header = (SGLMeshHeader*)file->data;
+    bool32 valid = header->magic == SGL_MESH_MAGIC &&
+                   header->version == SGL_MESH_VERSION &&
+                   header->attribute_count <= SGL_MESH_MAX_ATTRIBUTES &&
+                   header->lod_count <= SGL_MESH_MAX_LODS &&
+                   (header->index_type == GL_UNSIGNED_SHORT || header->index_type == GL_UNSIGNED_INT) &&
+                   header->vertex_size == (uint64)header->vertex_count*header->vertex_stride &&
+                   header->index_size == (uint64)header->index_count*(header->index_type == GL_UNSIGNED_SHORT ? 2 : 4) &&
+                   sgl_internal_mesh_blob_valid(file, header->vertex_offset, header->vertex_size) &&
+                   sgl_internal_mesh_blob_valid(file, header->index_offset, header->index_size) &&
+                   sgl_internal_mesh_blob_valid(file, header->lod_offset, (uint64)header->lod_count*sizeof(SGLMeshLod)) &&
+                   sgl_internal_mesh_blob_valid(file, header->meshlet_offset, (uint64)header->meshlet_count*sizeof(SGLMeshMeshlet));
+    for(uint32 index = 0; valid && index < header->attribute_count; ++index)
+    {
+        SGLMeshAttribute* attribute = &header->attributes[index];
+        uint32 size = (attribute->components >= 1 && attribute->components <= 4) ? sgl_internal_mesh_attribute_size(attribute) : 0;
+        valid = size && attribute->offset <= header->vertex_stride && size <= header->vertex_stride - attribute->offset;
+    }
+    //LODs and meshlets go straight to glDrawElements, a range past the index buffer would read out of bounds.
+    SGLMeshLod* lods = (SGLMeshLod*)(file->data + header->lod_offset);
+    for(uint32 index = 0; valid && index < header->lod_count; ++index)
+    {
+        valid = sgl_internal_mesh_range_valid(lods[index].first_index, lods[index].index_count, header->index_count);
+    }
+    SGLMeshMeshlet* meshlets = (SGLMeshMeshlet*)(file->data + header->meshlet_offset);
+    for(uint32 index = 0; valid && index < header->meshlet_count; ++index)
+    {
+        valid = sgl_internal_mesh_range_valid(meshlets[index].first_index, meshlets[index].index_count, header->index_count);
+    }
+    if(!valid)
+    {
+        sgl_mesh_file_close(file);
+        return false;
+    }
+
+    file->header   = header;
+    file->lods     = lods;
+    file->meshlets = meshlets;
+    return true;
+}
+
+void
+sgl_mesh_file_close(SGLMeshFile* file)
+{
+#ifdef _WIN32
+    if(file->data)    UnmapViewOfFile(file->data);
+    if(file->mapping) CloseHandle(file->mapping);
+    if(file->file)    CloseHandle(file->file);
+#else
+    //@TODO: Other OS (munmap)
+   #error No other OS defined!
+#endif //_WIN32
+    *file = {};
+}
+
+//@NOTE: Allocates the buffer storage and copies straight from the file mapping into the driver's
+//mapping, the only copy is the one that has to happen.
+internal bool32
+sgl_internal_buffer_upload_mapped(GLenum target, const void* source, uint64 size)
+{
+    glBufferData(target, (GLsizeiptr)size, 0, GL_STATIC_DRAW);
+    if(!size)
+    {
+        return true;
+    }
+    void* destination = glMapBufferRange(target, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_BUFFER_BIT);
+    if(!destination)
+    {
+        //Some drivers refuse to map, let them do the copy.
+        glBufferData(target, (GLsizeiptr)size, source, GL_STATIC_DRAW);
+        return true;
+    }
+    memcpy(destination, source, (size_t)size);
+    return glUnmapBuffer(target) == GL_TRUE;
+}
+
+bool32
+sgl_mesh_upload(SGLMesh* mesh, SGLMeshFile* file)
+{
+    *mesh = {};
+    SGLMeshHeader* header = file->header;
+    mesh->vertex_count = header->vertex_count;
+    mesh->index_count  = header->index_count;
+    mesh->index_type   = header->index_type;
+    mesh->lod_count    = header->lod_count;
+    for(uint32 lod = 0; lod < header->lod_count; ++lod)
+    {
+        mesh->lods[lod] = file->lods[lod];
+    }
+    if(!mesh->lod_count)
+    {
+        mesh->lod_count = 1;
+        mesh->lods[0].first_index = 0;
+        mesh->lods[0].index_count = header->index_count;
+    }
+    for(int32 axis = 0; axis < 3; ++axis)
+    {
+        mesh->bounds_min[axis] = header->bounds_min[axis];
+        mesh->bounds_max[axis] = header->bounds_max[axis];
+    }
+
+    glGenVertexArrays(1, &mesh->vertex_array);
+    glBindVertexArray(mesh->vertex_array);
+
+    glGenBuffers(1, &mesh->vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vertex_buffer);
+    bool32 result = sgl_internal_buffer_upload_mapped(GL_ARRAY_BUFFER, file->data + header->vertex_offset, header->vertex_size);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, mesh->vertex_buffer, header->vertex_size, 0, "SGL Mesh Vertices");
+    for(uint32 index = 0; index < header->attribute_count; ++index)
+    {
+        SGLMeshAttribute* attribute = &header->attributes[index];
+        if(attribute->location == SGL_ATTRIBUTE_POSITION && attribute->normalized)
+        {
+            mesh->position_normalized = true;
+        }
+        glEnableVertexAttribArray(attribute->location);
+        glVertexAttribPointer(attribute->location, attribute->components, attribute->type,
+                              attribute->normalized ? GL_TRUE : GL_FALSE, header->vertex_stride,
+                              (const void*)(size_t)attribute->offset);
+    }
+
+    glGenBuffers(1, &mesh->index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->index_buffer);
+    result = sgl_internal_buffer_upload_mapped(GL_ELEMENT_ARRAY_BUFFER, file->data + header->index_offset, header->index_size) && result;
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, mesh->index_buffer, header->index_size, header->index_type, "SGL Mesh Indices");
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return result;
+}
+
+bool32
+sgl_mesh_load(SGLMesh* mesh, const char* path)
+{
+    SGLMeshFile file;
+    if(!sgl_mesh_file_open(&file, path))
+    {
+        return false;
+    }
+    bool32 result = sgl_mesh_upload(mesh, &file);
+    sgl_mesh_file_close(&file);
+    if(result)
+    {
+        sgl_debug_label(GL_VERTEX_ARRAY, mesh->vertex_array, path);
+    }
+    return result;
+}
+
+void
+sgl_mesh_free(SGLMesh* mesh)
+{
+    glDeleteVertexArrays(1, &mesh->vertex_array);
+    sgl_internal_buffer_delete(&mesh->vertex_buffer);
+    sgl_internal_buffer_delete(&mesh->index_buffer);
+    *mesh = {};
+}
+
+void
+sgl_mesh_draw(SGLMesh* mesh, uint32 lod)
+{
+    if(lod >= mesh->lod_count)
+    {
+        lod = mesh->lod_count - 1;
+    }
+    uint32 index_size = (mesh->index_type == GL_UNSIGNED_SHORT) ? 2 : 4;
+    glBindVertexArray(mesh->vertex_array);
+    glDrawElements(GL_TRIANGLES, mesh->lods[lod].index_count, mesh->index_type,
+                   (const void*)(size_t)(mesh->lods[lod].first_index*index_size));
+    glBindVertexArray(0);
+}
+
+void
+sgl_mesh_position_decode(SGLMesh* mesh, float* scale, float* offset)
+{
+    for(int32 axis = 0; axis < 3; ++axis)
+    {
+        if(mesh->position_normalized)
+        {
+            scale[axis]  = (mesh->bounds_max[axis] - mesh->bounds_min[axis])*0.5f;
+            offset[axis] = (mesh->bounds_max[axis] + mesh->bounds_min[axis])*0.5f;
+        }
+        else
+        {
+            scale[axis]  = 1.0f;
+            offset[axis] = 0.0f;
+        }
+    }
+}
+
+#ifdef SGL_MESH_CONVERTER
+
+#include <stdlib.h>
+
+struct sgl_obj_vertex {
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+struct sgl_obj_array {
+    uint8* data;
+    uint32 count;
+    uint32 capacity;
+    uint32 element_size;
+};
+
+//@NOTE: Returns 0 when the array can't grow, the elements already in it are left alone.
+internal void*
+sgl_internal_obj_push(sgl_obj_array* array)
+{
+    if(array->count == array->capacity)
+    {
+        uint32 capacity = array->capacity ? array->capacity*2 : 1024;
+        uint8* data = (uint8*)realloc(array->data, (size_t)capacity*array->element_size);
+        if(!data)
+        {
+            return 0;
+        }
+        array->data     = data;
+        array->capacity = capacity;
+    }
+    return array->data + (size_t)(array->count++)*array->element_size;
+}
+
+//@NOTE: Resolves an obj index (1 based, negative = relative to the end) to 0 based, -1 if missing.
+internal int32
+sgl_internal_obj_index(const char** at, uint32 count)
+{
+    char* end;
+    long value = strtol(*at, &end, 10);
+    if(end == *at)
+    {
+        return -1;
+    }
+    *at = end;
+    if(value < 0)  return (int32)count + (int32)value;
+    if(value == 0) return -1;
+    return (int32)value - 1;
+}
+
+internal bool32
+sgl_internal_mesh_write_blob(FILE* out, const void* data, uint64 size, uint64* offset)
+{
+    local_persist const uint8 zeros[SGL_MESH_ALIGNMENT] = {};
+    uint64 padding = SGL_AlignPow2(*offset, (uint64)SGL_MESH_ALIGNMENT) - *offset;
+    if(padding && fwrite(zeros, 1, (size_t)padding, out) != padding)
+    {
+        return false;
+    }
+    *offset += padding;
+    if(size && fwrite(data, 1, (size_t)size, out) != size)
+    {
+        return false;
+    }
+    *offset += size;
+    return true;
+}
+
+bool32
+sgl_mesh_convert_obj(const char* obj_path, const char* mesh_path, SGLVertexFormat* format)
+{
+    FILE* in = fopen(obj_path, "rb");
+    if(!in)
+    {
+        fprintf(stderr, "Could not open [%s]\n", obj_path);
+        return false;
+    }
+    fseek(in, 0, SEEK_END);
+    long text_size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    char* text = (text_size >= 0) ? (char*)malloc((size_t)text_size + 1) : 0;
+    if(!text)
+    {
+        fprintf(stderr, "Could not read [%s]\n", obj_path);
+        fclose(in);
+        return false;
+    }
+    text_size = (long)fread(text, 1, text_size, in);
+    text[text_size] = 0;
+    fclose(in);
+
+    sgl_obj_array positions = {0, 0, 0, 3*sizeof(float)};
+    sgl_obj_array normals   = {0, 0, 0, 3*sizeof(float)};
+    sgl_obj_array uvs       = {0, 0, 0, 2*sizeof(float)};
+    sgl_obj_array vertices  = {0, 0, 0, sizeof(sgl_obj_vertex)};
+    sgl_obj_array indices   = {0, 0, 0, sizeof(uint32)};
+
+    //Deduplication table, keyed on the (position, uv, normal) index triple.
+    uint32 table_size = 1 << 16;
+    uint32* table_keys  = (uint32*)malloc(table_size*3*sizeof(uint32));
+    uint32* table_value = (uint32*)malloc(table_size*sizeof(uint32));
+    bool32 out_of_memory = !table_keys || !table_value;
+    if(table_value) memset(table_value, 0xFF, table_size*sizeof(uint32));
+
+    for(char* line = text; *line && !out_of_memory; )
+    {
+        char* next = line;
+        while(*next && *next != '\n') ++next;
+        if(*next) *next++ = 0;
+
+        const char* at = line;
+        while(*at == ' ' || *at == '\t') ++at;
+        if(at[0] == 'v' && (at[1] == ' ' || at[1] == '\t'))
+        {
+            float* position = (float*)sgl_internal_obj_push(&positions);
+            if(!position)
+            {
+                out_of_memory = true;
+                break;
+            }
+            char* end = (char*)at + 1;
+            for(int32 axis = 0; axis < 3; ++axis) position[axis] = strtof(end, &end);
+        }
+        else if(at[0] == 'v' && at[1] == 'n')
+        {
+            float* normal = (float*)sgl_internal_obj_push(&normals);
+            if(!normal)
+            {
+                out_of_memory = true;
+                break;
+            }
+            char* end = (char*)at + 2;
+            for(int32 axis = 0; axis < 3; ++axis) normal[axis] = strtof(end, &end);
+        }
+        else if(at[0] == 'v' && at[1] == 't')
+        {
+            float* uv = (float*)sgl_internal_obj_push(&uvs);
+            if(!uv)
+            {
+                out_of_memory = true;
+                break;
+            }
+            char* end = (char*)at + 2;
+            for(int32 axis = 0; axis < 2; ++axis) uv[axis] = strtof(end, &end);
+        }
+        else if(at[0] == 'f' && (at[1] == ' ' || at[1] == '\t'))
+        {
+            ++at;
+            uint32 face_vertices[64];
+            uint32 face_count = 0;
+            while(face_count < 64 && !out_of_memory)
+            {
+                while(*at == ' ' || *at == '\t' || *at == '\r') ++at;
+                if(!*at) break;
+
+                int32 key[3] = {-1, -1, -1}; //position, uv, normal
+                key[0] = sgl_internal_obj_index(&at, positions.count);
+                if(*at == '/')
+                {
+                    ++at;
+                    if(*at != '/') key[1] = sgl_internal_obj_index(&at, uvs.count);
+                    if(*at == '/')
+                    {
+                        ++at;
+                        key[2] = sgl_internal_obj_index(&at, normals.count);
+                    }
+                }
+                while(*at && *at != ' ' && *at != '\t' && *at != '\r') ++at;
+                if(key[0] < 0 || key[0] >= (int32)positions.count) continue;
+                if(key[1] >= (int32)uvs.count)     key[1] = -1;
+                if(key[2] >= (int32)normals.count) key[2] = -1;
+
+                //Grow the table when it's half full.
+                if(vertices.count*2 >= table_size)
+                {
+                    uint32 new_size = table_size*2;
+                    uint32* new_keys  = (uint32*)malloc(new_size*3*sizeof(uint32));
+                    uint32* new_value = (uint32*)malloc(new_size*sizeof(uint32));
+                    if(!new_keys || !new_value)
+                    {
+                        free(new_keys);
+                        free(new_value);
+                        out_of_memory = true;
+                        break;
+                    }
+                    memset(new_value, 0xFF, new_size*sizeof(uint32));
+                    for(uint32 slot = 0; slot < table_size; ++slot)
+                    {
+                        if(table_value[slot] == 0xFFFFFFFF) continue;
+                        uint32 hash = sgl_internal_hash32(&table_keys[slot*3], 3*sizeof(uint32)) & (new_size - 1);
+                        while(new_value[hash] != 0xFFFFFFFF) hash = (hash + 1) & (new_size - 1);
+                        memcpy(&new_keys[hash*3], &table_keys[slot*3], 3*sizeof(uint32));
+                        new_value[hash] = table_value[slot];
+                    }
+                    free(table_keys);
+                    free(table_value);
+                    table_keys  = new_keys;
+                    table_value = new_value;
+                    table_size  = new_size;
+                }
+
+                uint32 hash = sgl_internal_hash32(key, sizeof(key)) & (table_size - 1);
+                while(table_value[hash] != 0xFFFFFFFF && memcmp(&table_keys[hash*3], key, sizeof(key)) != 0)
+                {
+                    hash = (hash + 1) & (table_size - 1);
+                }
+                if(table_value[hash] == 0xFFFFFFFF)
+                {
+                    sgl_obj_vertex* vertex = (sgl_obj_vertex*)sgl_internal_obj_push(&vertices);
+                    if(!vertex)
+                    {
+                        out_of_memory = true;
+                        break;
+                    }
+                    *vertex = {};
+                    memcpy(vertex->position, positions.data + (size_t)key[0]*positions.element_size, 3*sizeof(float));
+                    if(key[1] >= 0) memcpy(vertex->uv, uvs.data + (size_t)key[1]*uvs.element_size, 2*sizeof(float));
+                    if(key[2] >= 0) memcpy(vertex->normal, normals.data + (size_t)key[2]*normals.element_size, 3*sizeof(float));
+                    memcpy(&table_keys[hash*3], key, sizeof(key));
+                    table_value[hash] = vertices.count - 1;
+                }
+                face_vertices[face_count++] = table_value[hash];
+            }
+            for(uint32 corner = 2; corner < face_count && !out_of_memory; ++corner)
+            {
+                uint32 triangle[3] = {face_vertices[0], face_vertices[corner - 1], face_vertices[corner]};
+                for(int32 vertex = 0; vertex < 3; ++vertex)
+                {
+                    uint32* index = (uint32*)sgl_internal_obj_push(&indices);
+                    if(!index)
+                    {
+                        out_of_memory = true;
+                        break;
+                    }
+                    *index = triangle[vertex];
+                }
+            }
+        }
+        line = next;
+    }
+    free(text);
+    free(table_keys);
+    free(table_value);
+    free(positions.data);
+    free(normals.data);
+    free(uvs.data);
+    if(out_of_memory)
+    {
+        fprintf(stderr, "Out of memory converting [%s]\n", obj_path);
+        free(vertices.data);
+        free(indices.data);
+        return false;
+    }
+
+    sgl_obj_vertex* vertex_data = (sgl_obj_vertex*)vertices.data;
+    uint32* index_data = (uint32*)indices.data;
+
+    SGLMeshHeader header = {};
+    header.magic           = SGL_MESH_MAGIC;
+    header.version         = SGL_MESH_VERSION;
+    header.index_count     = indices.count;
+    header.index_type      = (vertices.count <= 0xFFFF) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    //Vertex layout and bounds come from the quantizer.
+    SGLVertexFormat float_format = {};
+    SGLVertexStreams streams = {};
+    streams.vertex_count    = vertices.count;
+    streams.positions       = vertex_data ? vertex_data->position : 0;
+    streams.normals         = (vertex_data && normals.count) ? vertex_data->normal : 0;
+    streams.uvs             = (vertex_data && uvs.count) ? vertex_data->uv : 0;
+    streams.position_stride = sizeof(sgl_obj_vertex);
+    streams.normal_stride   = sizeof(sgl_obj_vertex);
+    streams.uv_stride       = sizeof(sgl_obj_vertex);
+    sgl_vertex_quantize(&streams, format ? *format : float_format, &header, 0);
+    void* packed_vertices = malloc((size_t)(header.vertex_size ? header.vertex_size : 1));
+    if(!packed_vertices)
+    {
+        fprintf(stderr, "Out of memory converting [%s]\n", obj_path);
+        free(vertices.data);
+        free(indices.data);
+        return false;
+    }
+    sgl_vertex_quantize(&streams, format ? *format : float_format, &header, packed_vertices);
+
+    //The index blob, 16 bit when it fits (narrowed in place).
+    uint64 index_element_size = (header.index_type == GL_UNSIGNED_SHORT) ? 2 : 4;
+    if(header.index_type == GL_UNSIGNED_SHORT)
+    {
+        uint16* narrow = (uint16*)index_data;
+        for(uint32 index = 0; index < indices.count; ++index) narrow[index] = (uint16)index_data[index];
+    }
+
+    //Meshlets, runs of up to 64 triangles in index order.
+    const uint32 meshlet_indices = 64*3;
+    header.meshlet_count = (indices.count + meshlet_indices - 1) / meshlet_indices;
+    SGLMeshMeshlet* meshlets = (SGLMeshMeshlet*)malloc((size_t)(header.meshlet_count ? header.meshlet_count : 1)*sizeof(SGLMeshMeshlet));
+    if(!meshlets)
+    {
+        fprintf(stderr, "Out of memory converting [%s]\n", obj_path);
+        free(packed_vertices);
+        free(vertices.data);
+        free(indices.data);
+        return false;
+    }
+    for(uint32 meshlet_index = 0; meshlet_index < header.meshlet_count; ++meshlet_index)
+    {
+        SGLMeshMeshlet* meshlet = &meshlets[meshlet_index];
+        meshlet->first_index = meshlet_index*meshlet_indices;
+        meshlet->index_count = (indices.count - meshlet->first_index < meshlet_indices) ? indices.count - meshlet->first_index : meshlet_indices;
+        float box_min[3], box_max[3];
+        for(uint32 corner = 0; corner < meshlet->index_count; ++corner)
+        {
+            uint32 vertex_index = (header.index_type == GL_UNSIGNED_SHORT) ? ((uint16*)index_data)[meshlet->first_index + corner]
+                                                                            : index_data[meshlet->first_index + corner];
+            for(int32 axis = 0; axis < 3; ++axis)
+            {
+                float value = vertex_data[vertex_index].position[axis];
+                if(corner == 0 || value < box_min[axis]) box_min[axis] = value;
+                if(corner == 0 || value > box_max[axis]) box_max[axis] = value;
+            }
+        }
+        float radius_squared = 0.0f;
+        for(int32 axis = 0; axis < 3; ++axis)
+        {
+            meshlet->center[axis] = (box_min[axis] + box_max[axis])*0.5f;
+            float half = (box_max[axis] - box_min[axis])*0.5f;
+            radius_squared += half*half;
+        }
+        meshlet->radius = sqrtf(radius_squared);
+    }
+
+    SGLMeshLod lod = {0, indices.count};
+    header.lod_count = 1;
+
+    uint64 offset = SGL_AlignPow2((uint64)sizeof(SGLMeshHeader), (uint64)SGL_MESH_ALIGNMENT);
+    header.vertex_offset  = offset;
+    offset = SGL_AlignPow2(offset + header.vertex_size, (uint64)SGL_MESH_ALIGNMENT);
+    header.index_size     = (uint64)indices.count*index_element_size;
+    header.index_offset   = offset;
+    offset = SGL_AlignPow2(offset + header.index_size, (uint64)SGL_MESH_ALIGNMENT);
+    header.lod_offset     = offset;
+    offset = SGL_AlignPow2(offset + sizeof(SGLMeshLod), (uint64)SGL_MESH_ALIGNMENT);
+    header.meshlet_offset = offset;
+
+    bool32 result = false;
+    FILE* out = fopen(mesh_path, "wb");
+    if(out)
+    {
+        uint64 written = 0;
+        result = sgl_internal_mesh_write_blob(out, &header, sizeof(header), &written) &&
+                 sgl_internal_mesh_write_blob(out, packed_vertices, header.vertex_size, &written) &&
+                 sgl_internal_mesh_write_blob(out, index_data, header.index_size, &written) &&
+                 sgl_internal_mesh_write_blob(out, &lod, sizeof(lod), &written) &&
+                 sgl_internal_mesh_write_blob(out, meshlets, (uint64)header.meshlet_count*sizeof(SGLMeshMeshlet), &written);
+        fclose(out);
+    }
+    if(!result)
+    {
+        fprintf(stderr, "Could not write [%s]\n", mesh_path);
+    }
+
+    free(meshlets);
+    free(packed_vertices);
+    free(vertices.data);
+    free(indices.data);
+    return result;
+}
+
+#endif //SGL_MESH_CONVERTER
+
+//[END Binary Meshes] ---------------------
+
+//
+//[Vertex Quantization] ---------------------
+
+const char* sgl_glsl_octahedral_decode =
+ "vec3 sgl_oct_decode(vec2 e)                                       \n"
+ "{                                                                 \n"
+ "    vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));               \n"
+ "    float t = max(-n.z, 0.0);                                     \n"
+ "    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);       \n"
+ "    return normalize(n);                                          \n"
+ "}                                                                 \n";
+
+union sgl_float_bits {
+    float  f;
+    uint32 u;
+};
+
+//@NOTE: Fabian Giesen's float_to_half_fast3_rtne, the SSE2 version below is the same thing 4 wide.
+internal uint16
+sgl_internal_half(float value)
+{
+    sgl_float_bits bits;
+    bits.f = value;
+    uint32 sign = bits.u & 0x80000000u;
+    bits.u ^= sign;
+
+    uint32 result;
+    if(bits.u >= ((127 + 16) << 23))
+    {
+        result = (bits.u > 0x7F800000u) ? 0x7E00 : 0x7C00; //NaN stays NaN, the rest is infinity
+    }
+    else if(bits.u < ((127 - 14) << 23))
+    {
+        //Subnormal, let the FPU do the rounding.
+        sgl_float_bits magic;
+        magic.u = ((127 - 15) + (23 - 10) + 1) << 23;
+        bits.f += magic.f;
+        result = bits.u - magic.u;
+    }
+    else
+    {
+        uint32 mantissa_odd = (bits.u >> 13) & 1;
+        bits.u += ((uint32)(15 - 127) << 23) + 0xFFF;
+        bits.u += mantissa_odd;
+        result = bits.u >> 13;
+    }
+    return (uint16)(result | (sign >> 16));
+}
+
+#if SGL_SSE2
+//Returns the halves in the low 16 bits of each 32 bit lane, sign extended.
+internal inline __m128i
+sgl_internal_half4(__m128 value)
+{
+#if SGL_F16C
+    return _mm_srai_epi32(_mm_slli_epi32(_mm_cvtepu16_epi32(_mm_cvtps_ph(value, 0)), 16), 16);
+#else
+    const __m128i f16_max        = _mm_set1_epi32((127 + 16) << 23);
+    const __m128i min_normal     = _mm_set1_epi32((127 - 14) << 23);
+    const __m128i subnormal_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+    const __m128i normal_bias    = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));
+
+    __m128 just_sign = _mm_and_ps(_mm_castsi128_ps(_mm_set1_epi32(0x80000000)), value);
+    __m128 abs_value = _mm_xor_ps(value, just_sign);
+    __m128i abs_bits = _mm_castps_si128(abs_value);
+
+    __m128 is_nan = _mm_cmpunord_ps(abs_value, abs_value);
+    __m128i is_regular = _mm_cmpgt_epi32(f16_max, abs_bits);
+    __m128i inf_or_nan = _mm_or_si128(_mm_and_si128(_mm_castps_si128(is_nan), _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7C00));
+
+    __m128i is_subnormal = _mm_cmpgt_epi32(min_normal, abs_bits);
+    __m128 subnormal_sum = _mm_add_ps(abs_value, _mm_castsi128_ps(subnormal_magic));
+    __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormal_sum), subnormal_magic);
+
+    __m128i mantissa_odd = _mm_srai_epi32(_mm_slli_epi32(abs_bits, 31 - 13), 31);
+    __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(abs_bits, normal_bias), mantissa_odd), 13);
+
+    __m128i non_special = _mm_or_si128(_mm_and_si128(subnormal, is_subnormal), _mm_andnot_si128(is_subnormal, normal));
+    __m128i joined = _mm_or_si128(_mm_and_si128(non_special, is_regular), _mm_andnot_si128(is_regular, inf_or_nan));
+    return _mm_or_si128(joined, _mm_srai_epi32(_mm_castps_si128(just_sign), 16));
+#endif
+}
+#endif //SGL_SSE2
+
+void
+sgl_float_to_half(const float* source, uint16* dest, uint32 count)
+{
+    uint32 index = 0;
+#if SGL_SSE2
+    for(; index + 8 <= count; index += 8)
+    {
+        __m128i low  = sgl_internal_half4(_mm_loadu_ps(source + index));
+        __m128i high = sgl_internal_half4(_mm_loadu_ps(source + index + 4));
+        _mm_storeu_si128((__m128i*)(dest + index), _mm_packs_epi32(low, high));
+    }
+#endif
+    for(; index < count; ++index)
+    {
+        dest[index] = sgl_internal_half(source[index]);
+    }
+}
+
+internal inline float
+sgl_internal_clamp(float value, float min, float max)
+{
+    return (value < min) ? min : ((value > max) ? max : value);
+}
+
+internal inline int32
+sgl_internal_round(float value)
+{
+    return (int32)((value >= 0.0f) ? value + 0.5f : value - 0.5f);
+}
+
+//@NOTE: Octahedral mapping of a unit vector to [-1, 1]^2.
+internal inline void
+sgl_internal_octahedral_encode(const float* normal, float* encoded)
+{
+    float length = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+    float inv_length = (length > 0.0f) ? 1.0f / length : 0.0f;
+    float x = normal[0]*inv_length;
+    float y = normal[1]*inv_length;
+    if(normal[2] < 0.0f)
+    {
+        float folded_x = (1.0f - fabsf(y))*((x >= 0.0f) ? 1.0f : -1.0f);
+        float folded_y = (1.0f - fabsf(x))*((y >= 0.0f) ? 1.0f : -1.0f);
+        x = folded_x;
+        y = folded_y;
+    }
+    encoded[0] = x;
+    encoded[1] = y;
+}
+
+internal inline uint32
+sgl_internal_pack_10_10_10_2(float x, float y, float z, float w)
+{
+    uint32 packed_x = (uint32)sgl_internal_round(sgl_internal_clamp(x, -1.0f, 1.0f)*511.0f) & 0x3FF;
+    uint32 packed_y = (uint32)sgl_internal_round(sgl_internal_clamp(y, -1.0f, 1.0f)*511.0f) & 0x3FF;
+    uint32 packed_z = (uint32)sgl_internal_round(sgl_internal_clamp(z, -1.0f, 1.0f)*511.0f) & 0x3FF;
+    uint32 packed_w = (w < 0.0f) ? 0x3 : 0x1; //2 bit snorm, -1 or 1
+    return packed_x | (packed_y << 10) | (packed_z << 20) | (packed_w << 30);
+}
+
+//@NOTE: Encoders work 4 vertices at a time. The streams are strided (often interleaved) so the 4
+//values of a component are gathered into a register, converted together and scattered back out.
+#define SGL_QUANTIZE_GATHER(stream, stride, vertex, component) \
+    (*(const float*)((const uint8*)(stream) + (size_t)(vertex)*(stride) + (component)*sizeof(float)))
+
+internal void
+sgl_internal_quantize_half(const float* stream, uint32 stride, uint32 components, uint32 padded_components,
+                           uint32 vertex_count, uint8* out, uint32 out_stride)
+{
+    uint32 vertex = 0;
+#if SGL_SSE2
+    for(; vertex + 4 <= vertex_count; vertex += 4)
+    {
+        for(uint32 component = 0; component < components; ++component)
+        {
+            __m128 values = _mm_set_ps(SGL_QUANTIZE_GATHER(stream, stride, vertex + 3, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 2, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 1, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 0, component));
+            SGL_ALIGN16 int32 halves[4];
+            _mm_store_si128((__m128i*)halves, sgl_internal_half4(values));
+            for(uint32 lane = 0; lane < 4; ++lane)
+            {
+                ((uint16*)(out + (size_t)(vertex + lane)*out_stride))[component] = (uint16)halves[lane];
+            }
+        }
+        for(uint32 lane = 0; lane < 4; ++lane)
+        {
+            for(uint32 component = components; component < padded_components; ++component)
+            {
+                ((uint16*)(out + (size_t)(vertex + lane)*out_stride))[component] = 0x3C00; //1.0
+            }
+        }
+    }
+#endif
+    for(; vertex < vertex_count; ++vertex)
+    {
+        uint16* dest = (uint16*)(out + (size_t)vertex*out_stride);
+        for(uint32 component = 0; component < padded_components; ++component)
+        {
+            dest[component] = (component < components) ? sgl_internal_half(SGL_QUANTIZE_GATHER(stream, stride, vertex, component)) : 0x3C00;
+        }
+    }
+}
+
+//dest = round(clamp((value - offset)*scale, min, max)*range) as 16 bit, for snorm16 and unorm16.
+internal void
+sgl_internal_quantize_16(const float* stream, uint32 stride, uint32 components, uint32 padded_components,
+                         const float* offset, const float* scale, bool32 is_signed,
+                         uint32 vertex_count, uint8* out, uint32 out_stride)
+{
+    float min   = is_signed ? -1.0f : 0.0f;
+    float range = is_signed ? 32767.0f : 65535.0f;
+    uint16 one  = is_signed ? 32767 : 65535;
+    uint32 vertex = 0;
+#if SGL_SSE2
+    for(; vertex + 4 <= vertex_count; vertex += 4)
+    {
+        for(uint32 component = 0; component < components; ++component)
+        {
+            __m128 values = _mm_set_ps(SGL_QUANTIZE_GATHER(stream, stride, vertex + 3, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 2, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 1, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 0, component));
+            values = _mm_mul_ps(_mm_sub_ps(values, _mm_set1_ps(offset[component])), _mm_set1_ps(scale[component]));
+            values = _mm_min_ps(_mm_max_ps(values, _mm_set1_ps(min)), _mm_set1_ps(1.0f));
+            SGL_ALIGN16 int32 quantized[4];
+            _mm_store_si128((__m128i*)quantized, _mm_cvtps_epi32(_mm_mul_ps(values, _mm_set1_ps(range))));
+            for(uint32 lane = 0; lane < 4; ++lane)
+            {
+                ((uint16*)(out + (size_t)(vertex + lane)*out_stride))[component] = (uint16)quantized[lane];
+            }
+        }
+        for(uint32 lane = 0; lane < 4; ++lane)
+        {
+            for(uint32 component = components; component < padded_components; ++component)
+            {
+                ((uint16*)(out + (size_t)(vertex + lane)*out_stride))[component] = one;
+            }
+        }
+    }
+#endif
+    for(; vertex < vertex_count; ++vertex)
+    {
+        uint16* dest = (uint16*)(out + (size_t)vertex*out_stride);
+        for(uint32 component = 0; component < padded_components; ++component)
+        {
+            if(component < components)
+            {
+                float value = (SGL_QUANTIZE_GATHER(stream, stride, vertex, component) - offset[component])*scale[component];
+                dest[component] = (uint16)sgl_internal_round(sgl_internal_clamp(value, min, 1.0f)*range);
+            }
+            else
+            {
+                dest[component] = one;
+            }
+        }
+    }
+}
+
+internal void
+sgl_internal_quantize_10_10_10_2(const float* stream, uint32 stride, bool32 has_w,
+                                 uint32 vertex_count, uint8* out, uint32 out_stride)
+{
+    uint32 vertex = 0;
+#if SGL_SSE2
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minus_one = _mm_set1_ps(-1.0f);
+    const __m128 scale = _mm_set1_ps(511.0f);
+    const __m128i mask = _mm_set1_epi32(0x3FF);
+    for(; vertex + 4 <= vertex_count; vertex += 4)
+    {
+        __m128i packed = _mm_setzero_si128();
+        for(uint32 component = 0; component < 3; ++component)
+        {
+            __m128 values = _mm_set_ps(SGL_QUANTIZE_GATHER(stream, stride, vertex + 3, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 2, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 1, component),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 0, component));
+            values = _mm_min_ps(_mm_max_ps(values, minus_one), one);
+            __m128i quantized = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(values, scale)), mask);
+            packed = _mm_or_si128(packed, (component == 0) ? quantized :
+                                          (component == 1) ? _mm_slli_epi32(quantized, 10) : _mm_slli_epi32(quantized, 20));
+        }
+        __m128i w = _mm_set1_epi32(0x1 << 30);
+        if(has_w)
+        {
+            __m128 values = _mm_set_ps(SGL_QUANTIZE_GATHER(stream, stride, vertex + 3, 3),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 2, 3),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 1, 3),
+                                       SGL_QUANTIZE_GATHER(stream, stride, vertex + 0, 3));
+            //Negative w -> 0x3 (-1), else 0x1 (1)
+            __m128i negative = _mm_castps_si128(_mm_cmplt_ps(values, _mm_setzero_ps()));
+            w = _mm_or_si128(w, _mm_and_si128(negative, _mm_set1_epi32(0x2 << 30)));
+        }
+        packed = _mm_or_si128(packed, w);
+        SGL_ALIGN16 uint32 lanes[4];
+        _mm_store_si128((__m128i*)lanes, packed);
+        for(uint32 lane = 0; lane < 4; ++lane)
+        {
+            *(uint32*)(out + (size_t)(vertex + lane)*out_stride) = lanes[lane];
+        }
+    }
+#endif
+    for(; vertex < vertex_count; ++vertex)
+    {
+        float w = has_w ? SGL_QUANTIZE_GATHER(stream, stride, vertex, 3) : 1.0f;
+        *(uint32*)(out + (size_t)vertex*out_stride) = sgl_internal_pack_10_10_10_2(SGL_QUANTIZE_GATHER(stream, stride, vertex, 0),
+                                                                                   SGL_QUANTIZE_GATHER(stream, stride, vertex, 1),
+                                                                                   SGL_QUANTIZE_GATHER(stream, stride, vertex, 2), w);
+    }
+}
+
+internal void
+sgl_internal_quantize_octahedral(const float* stream, uint32 stride, uint32 vertex_count, uint8* out, uint32 out_stride)
+{
+    //@NOTE: The octahedral fold is branchy, the encode is scalar and the snorm conversion goes
+    //through the 4 wide path with the encoded pairs as a tightly packed stream.
+    const uint32 batch_size = 256;
+    float encoded[batch_size*2];
+    const float offset[2] = {0.0f, 0.0f};
+    const float scale[2]  = {1.0f, 1.0f};
+    for(uint32 first = 0; first < vertex_count; first += batch_size)
+    {
+        uint32 count = (vertex_count - first < batch_size) ? vertex_count - first : batch_size;
+        for(uint32 index = 0; index < count; ++index)
+        {
+            const float* normal = (const float*)((const uint8*)stream + (size_t)(first + index)*stride);
+            sgl_internal_octahedral_encode(normal, &encoded[index*2]);
+        }
+        sgl_internal_quantize_16(encoded, 2*sizeof(float), 2, 2, offset, scale, true,
+                                 count, out + (size_t)first*out_stride, out_stride);
+    }
+}
+
+internal void
+sgl_internal_quantize_float(const float* stream, uint32 stride, uint32 components,
+                            uint32 vertex_count, uint8* out, uint32 out_stride)
+{
+    for(uint32 vertex = 0; vertex < vertex_count; ++vertex)
+    {
+        memcpy(out + (size_t)vertex*out_stride, (const uint8*)stream + (size_t)vertex*stride, components*sizeof(float));
+    }
+}
+
+internal void
+sgl_internal_add_attribute(SGLMeshHeader* header, uint32 location, uint32 components, uint32 type, bool32 normalized, uint32 size)
+{
+    SGL_Assert(header->attribute_count < SGL_MESH_MAX_ATTRIBUTES);
+    SGLMeshAttribute* attribute = &header->attributes[header->attribute_count++];
+    attribute->location   = location;
+    attribute->components = components;
+    attribute->type       = type;
+    attribute->normalized = normalized;
+    attribute->offset     = header->vertex_stride;
+    header->vertex_stride += size;
+}
+
+void
+sgl_vertex_quantize(SGLVertexStreams* streams, SGLVertexFormat format, SGLMeshHeader* header, void* vertices)
+{
+    uint32 vertex_count    = streams->vertex_count;
+    uint32 position_stride = streams->position_stride ? streams->position_stride : 3*sizeof(float);
+    uint32 normal_stride   = streams->normal_stride   ? streams->normal_stride   : 3*sizeof(float);
+    uint32 tangent_stride  = streams->tangent_stride  ? streams->tangent_stride  : 4*sizeof(float);
+    uint32 uv_stride       = streams->uv_stride       ? streams->uv_stride       : 2*sizeof(float);
+
+    //Bounds, positions are normalized against them for SGL_POSITION_SNORM16.
+    for(int32 axis = 0; axis < 3; ++axis)
+    {
+        header->bounds_min[axis] = vertex_count ? SGL_QUANTIZE_GATHER(streams->positions, position_stride, 0, axis) : 0.0f;
+        header->bounds_max[axis] = header->bounds_min[axis];
+    }
+    for(uint32 vertex = 1; vertex < vertex_count; ++vertex)
+    {
+        for(int32 axis = 0; axis < 3; ++axis)
+        {
+            float value = SGL_QUANTIZE_GATHER(streams->positions, position_stride, vertex, axis);
+            if(value < header->bounds_min[axis]) header->bounds_min[axis] = value;
+            if(value > header->bounds_max[axis]) header->bounds_max[axis] = value;
+        }
+    }
+
+    //Layout. Everything is kept 4 byte aligned, the 16 bit positions are padded to 4 components (w = 1).
+    header->attribute_count = 0;
+    header->vertex_stride = 0;
+    uint32 position_offset, normal_offset = 0, tangent_offset = 0, uv_offset = 0;
+    position_offset = header->vertex_stride;
+    switch(format.position)
+    {
+        case SGL_POSITION_FLOAT:   sgl_internal_add_attribute(header, SGL_ATTRIBUTE_POSITION, 3, GL_FLOAT, false, 12); break;
+        case SGL_POSITION_HALF:    sgl_internal_add_attribute(header, SGL_ATTRIBUTE_POSITION, 4, GL_HALF_FLOAT, false, 8); break;
+        case SGL_POSITION_SNORM16: sgl_internal_add_attribute(header, SGL_ATTRIBUTE_POSITION, 4, GL_SHORT, true, 8); break;
+        InvalidDefaultCase;
+    }
+    if(streams->normals)
+    {
+        normal_offset = header->vertex_stride;
+        switch(format.normal)
+        {
+            case SGL_NORMAL_FLOAT:             sgl_internal_add_attribute(header, SGL_ATTRIBUTE_NORMAL, 3, GL_FLOAT, false, 12); break;
+            case SGL_NORMAL_PACKED_10_10_10_2: sgl_internal_add_attribute(header, SGL_ATTRIBUTE_NORMAL, 4, GL_INT_2_10_10_10_REV, true, 4); break;
+            case SGL_NORMAL_OCTAHEDRAL_16:     sgl_internal_add_attribute(header, SGL_ATTRIBUTE_NORMAL, 2, GL_SHORT, true, 4); break;
+            InvalidDefaultCase;
+        }
+    }
+    if(streams->tangents)
+    {
+        tangent_offset = header->vertex_stride;
+        if(format.normal == SGL_NORMAL_FLOAT)
+        {
+            sgl_internal_add_attribute(header, SGL_ATTRIBUTE_TANGENT, 4, GL_FLOAT, false, 16);
+        }
+        else
+        {
+            sgl_internal_add_attribute(header, SGL_ATTRIBUTE_TANGENT, 4, GL_INT_2_10_10_10_REV, true, 4);
+        }
+    }
+    if(streams->uvs)
+    {
+        uv_offset = header->vertex_stride;
+        switch(format.uv)
+        {
+            case SGL_UV_FLOAT:   sgl_internal_add_attribute(header, SGL_ATTRIBUTE_UV, 2, GL_FLOAT, false, 8); break;
+            case SGL_UV_HALF:    sgl_internal_add_attribute(header, SGL_ATTRIBUTE_UV, 2, GL_HALF_FLOAT, false, 4); break;
+            case SGL_UV_UNORM16: sgl_internal_add_attribute(header, SGL_ATTRIBUTE_UV, 2, GL_UNSIGNED_SHORT, true, 4); break;
+            InvalidDefaultCase;
+        }
+    }
+    header->vertex_count = vertex_count;
+    header->vertex_size  = (uint64)vertex_count*header->vertex_stride;
+
+    if(!vertices)
+    {
+        return;
+    }
+    uint8* out = (uint8*)vertices;
+    uint32 out_stride = header->vertex_stride;
+
+    switch(format.position)
+    {
+        case SGL_POSITION_FLOAT:
+        {
+            sgl_internal_quantize_float(streams->positions, position_stride, 3, vertex_count, out + position_offset, out_stride);
+        }break;
+        case SGL_POSITION_HALF:
+        {
+            sgl_internal_quantize_half(streams->positions, position_stride, 3, 4, vertex_count, out + position_offset, out_stride);
+        }break;
+        case SGL_POSITION_SNORM16:
+        {
+            float offset[3], scale[3];
+            for(int32 axis = 0; axis < 3; ++axis)
+            {
+                float half_size = (header->bounds_max[axis] - header->bounds_min[axis])*0.5f;
+                offset[axis] = (header->bounds_max[axis] + header->bounds_min[axis])*0.5f;
+                scale[axis]  = (half_size > 0.0f) ? 1.0f / half_size : 0.0f;
+            }
+            sgl_internal_quantize_16(streams->positions, position_stride, 3, 4, offset, scale, true,
+                                     vertex_count, out + position_offset, out_stride);
+        }break;
+        InvalidDefaultCase;
+    }
+    if(streams->normals)
+    {
+        switch(format.normal)
+        {
+            case SGL_NORMAL_FLOAT:
+            {
+                sgl_internal_quantize_float(streams->normals, normal_stride, 3, vertex_count, out + normal_offset, out_stride);
+            }break;
+            case SGL_NORMAL_PACKED_10_10_10_2:
+            {
+                sgl_internal_quantize_10_10_10_2(streams->normals, normal_stride, false, vertex_count, out + normal_offset, out_stride);
+            }break;
+            case SGL_NORMAL_OCTAHEDRAL_16:
+            {
+                sgl_internal_quantize_octahedral(streams->normals, normal_stride, vertex_count, out + normal_offset, out_stride);
+            }break;
+            InvalidDefaultCase;
+        }
+    }
+    if(streams->tangents)
+    {
+        if(format.normal == SGL_NORMAL_FLOAT)
+        {
+            sgl_internal_quantize_float(streams->tangents, tangent_stride, 4, vertex_count, out + tangent_offset, out_stride);
+        }
+        else
+        {
+            sgl_internal_quantize_10_10_10_2(streams->tangents, tangent_stride, true, vertex_count, out + tangent_offset, out_stride);
+        }
+    }
+    if(streams->uvs)
+    {
+        switch(format.uv)
+        {
+            case SGL_UV_FLOAT:
+            {
+                sgl_internal_quantize_float(streams->uvs, uv_stride, 2, vertex_count, out + uv_offset, out_stride);
+            }break;
+            case SGL_UV_HALF:
+            {
+                sgl_internal_quantize_half(streams->uvs, uv_stride, 2, 2, vertex_count, out + uv_offset, out_stride);
+            }break;
+            case SGL_UV_UNORM16:
+            {
+                const float offset[2] = {0.0f, 0.0f};
+                const float scale[2]  = {1.0f, 1.0f};
+                sgl_internal_quantize_16(streams->uvs, uv_stride, 2, 2, offset, scale, false,
+                                         vertex_count, out + uv_offset, out_stride);
+            }break;
+            InvalidDefaultCase;
+        }
+    }
+}
+
+//[END Vertex Quantization] ---------------------
+
+//
+//[Sprite Batching] ---------------------
+
+char* sgl_sprite_vertex_shader =
+ "#version 330                                                      \n"
+ "//Sprite VERT                                                     \n"
+ "layout (location = 0) in vec2 position;                           \n"
+ "layout (location = 1) in vec2 uv;                                 \n"
+ "layout (location = 2) in vec4 color;                              \n"
+ "uniform vec2 viewport;                                            \n"
+ "out vec2 frag_uv;                                                 \n"
+ "out vec4 frag_color;                                              \n"
+ "void main()                                                       \n"
+ "{                                                                 \n"
+ "    vec2 ndc = position/viewport*2.0 - 1.0;                       \n"
+ "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);                  \n"
+ "    frag_uv = uv;                                                 \n"
+ "    frag_color = color;                                           \n"
+ "}                                                                 \n";
+
+char* sgl_sprite_frag_shader =
+ "#version 330                                \n"
+ "//Sprite FRAG                               \n"
+ "in vec2 frag_uv;                            \n"
+ "in vec4 frag_color;                         \n"
+ "uniform sampler2D atlas;                    \n"
+ "out vec4 color;                             \n"
+ "void main()                                 \n"
+ "{                                           \n"
+ "    color = texture(atlas, frag_uv)*frag_color; \n"
+ "}                                           \n";
+
+//[INTERNAL] 20 bytes, what the SIMD path writes.
+struct sgl_sprite_vertex {
+    float position[2];
+    float uv[2];
+    uint32 color;
+};
+
+//@NOTE: Tracked under the caller's function/line, see [GPU Memory].
+#define sgl_internal_texture_create(...) sgl_internal_texture_create_at(__FUNCTION__, __LINE__, __VA_ARGS__)
+
+internal GLuint
+sgl_internal_texture_create_at(const char* function, int32 line, int32 width, int32 height, GLenum internal_format,
+                               GLenum format, const void* pixels, GLenum type = GL_UNSIGNED_BYTE)
+{
+    GLuint texture;
+    glGenTextures(1, &texture);
+    sgl_gpu_memory_track(SGL_GPU_TEXTURE, texture, (uint64)width*height*sgl_internal_format_bytes(internal_format),
+                         internal_format, 0, function, line);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, pixels);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+void
+sgl_atlas_clear(SGLAtlas* atlas)
+{
+    atlas->node_count = 1;
+    atlas->nodes[0].x = 0;
+    atlas->nodes[0].y = 0;
+    atlas->nodes[0].width = atlas->width;
+}
+
+bool32
+sgl_atlas_create(SGLAtlas* atlas, int32 width, int32 height)
+{
+    atlas->width   = width;
+    atlas->height  = height;
+    atlas->padding = 1;
+    sgl_atlas_clear(atlas);
+    //Start from transparent black, undefined padding texels would bleed into sprite edges through GL_LINEAR.
+    void* zeros = sgl_internal_alloc((size_t)width*height*4);
+    if(!zeros)
+    {
+        return false;
+    }
+    atlas->texture = sgl_internal_texture_create(width, height, GL_RGBA8, GL_RGBA, zeros);
+    sgl_internal_free(zeros);
+    sgl_debug_label(GL_TEXTURE, atlas->texture, "SGL Atlas");
+    return atlas->texture != 0;
+}
+
+void
+sgl_atlas_free(SGLAtlas* atlas)
+{
+    sgl_internal_texture_delete(&atlas->texture);
+    atlas->node_count = 0;
+}
+
+//@NOTE: Returns the y a width x height rectangle would sit at if placed on node index, -1 if it can't.
+internal int32
+sgl_internal_skyline_fit(SGLAtlas* atlas, int32 index, int32 width, int32 height)
+{
+    int32 x = atlas->nodes[index].x;
+    if(x + width > atlas->width)
+    {
+        return -1;
+    }
+    int32 y = 0;
+    int32 remaining = width;
+    for(int32 node = index; remaining > 0; ++node)
+    {
+        if(node >= atlas->node_count)
+        {
+            return -1;
+        }
+        if(atlas->nodes[node].y > y)
+        {
+            y = atlas->nodes[node].y;
+        }
+        if(y + height > atlas->height)
+        {
+            return -1;
+        }
+        remaining -= atlas->nodes[node].width;
+    }
+    return y;
+}
+
+//Skyline bottom-left, Jukka Jylanki's "A Thousand Ways to Pack the Bin".
+internal bool32
+sgl_internal_skyline_pack(SGLAtlas* atlas, int32 width, int32 height, int32* out_x, int32* out_y)
+{
+    int32 best_index = -1;
+    int32 best_y = 0x7FFFFFFF;
+    int32 best_width = 0x7FFFFFFF;
+    for(int32 index = 0; index < atlas->node_count; ++index)
+    {
+        int32 y = sgl_internal_skyline_fit(atlas, index, width, height);
+        if(y >= 0 && (y + height < best_y || (y + height == best_y && atlas->nodes[index].width < best_width)))
+        {
+            best_index = index;
+            best_y = y + height;
+            best_width = atlas->nodes[index].width;
+        }
+    }
+    if(best_index < 0 || atlas->node_count >= SGL_ATLAS_MAX_NODES)
+    {
+        return false;
+    }
+
+    *out_x = atlas->nodes[best_index].x;
+    *out_y = best_y - height;
+
+    //Insert the new skyline segment and shift the rest.
+    for(int32 index = atlas->node_count; index > best_index; --index)
+    {
+        atlas->nodes[index] = atlas->nodes[index - 1];
+    }
+    ++atlas->node_count;
+    atlas->nodes[best_index].x = *out_x;
+    atlas->nodes[best_index].y = best_y;
+    atlas->nodes[best_index].width = width;
+
+    //Trim the segments the new one now covers.
+    for(int32 index = best_index + 1; index < atlas->node_count; )
+    {
+        SGLAtlasNode* previous = &atlas->nodes[index - 1];
+        SGLAtlasNode* node = &atlas->nodes[index];
+        int32 overlap = previous->x + previous->width - node->x;
+        if(overlap <= 0)
+        {
+            break;
+        }
+        node->x += overlap;
+        node->width -= overlap;
+        if(node->width > 0)
+        {
+            break;
+        }
+        for(int32 move = index; move < atlas->node_count - 1; ++move)
+        {
+            atlas->nodes[move] = atlas->nodes[move + 1];
+        }
+        --atlas->node_count;
+    }
+
+    //Merge neighbours at the same height.
+    for(int32 index = 0; index < atlas->node_count - 1; )
+    {
+        if(atlas->nodes[index].y == atlas->nodes[index + 1].y)
+        {
+            atlas->nodes[index].width += atlas->nodes[index + 1].width;
+            for(int32 move = index + 1; move < atlas->node_count - 1; ++move)
+            {
+                atlas->nodes[move] = atlas->nodes[move + 1];
+            }
+            --atlas->node_count;
+        }
+        else
+        {
+            ++index;
+        }
+    }
+    return true;
+}
+
+bool32
+sgl_atlas_add(SGLAtlas* atlas, int32 width, int32 height, const void* rgba_pixels, SGLSpriteRegion* region)
+{
+    int32 x, y;
+    if(!sgl_internal_skyline_pack(atlas, width + atlas->padding, height + atlas->padding, &x, &y))
+    {
+        return false;
+    }
+    if(rgba_pixels)
+    {
+        glBindTexture(GL_TEXTURE_2D, atlas->texture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba_pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+    region->texture = atlas->texture;
+    region->x       = x;
+    region->y       = y;
+    region->width   = width;
+    region->height  = height;
+    region->u0 = (float)x / (float)atlas->width;
+    region->v0 = (float)y / (float)atlas->height;
+    region->u1 = (float)(x + width) / (float)atlas->width;
+    region->v1 = (float)(y + height) / (float)atlas->height;
+    return true;
+}
+
+bool32
+sgl_sprite_batch_create(SGLSpriteBatch* batch, uint32 capacity)
+{
+    *batch = {};
+    batch->sprites = (sgl_sprite*)sgl_internal_alloc(capacity*sizeof(sgl_sprite));
+    uint32* indices = (uint32*)sgl_internal_alloc(capacity*6*sizeof(uint32));
+    if(!batch->sprites || !indices)
+    {
+        sgl_internal_free(batch->sprites);
+        sgl_internal_free(indices);
+        return false;
+    }
+    batch->capacity = capacity;
+
+    GLuint shader_list[2] = 
+    {
+        sgl_internal_shader_create(GL_VERTEX_SHADER, sgl_sprite_vertex_shader),
+        sgl_internal_shader_create(GL_FRAGMENT_SHADER, sgl_sprite_frag_shader)
+    };
+    batch->program = sgl_internal_program_create(shader_list, 2, "SGL Sprite Batch");
+    glDeleteShader(shader_list[0]);
+    glDeleteShader(shader_list[1]);
+    batch->viewport_location = glGetUniformLocation(batch->program, "viewport");
+    batch->texture_location  = glGetUniformLocation(batch->program, "atlas");
+
+    glGenVertexArrays(1, &batch->vertex_array);
+    glBindVertexArray(batch->vertex_array);
+    glGenBuffers(1, &batch->vertex_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER, capacity*4*sizeof(sgl_sprite_vertex), 0, GL_STREAM_DRAW);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, batch->vertex_buffer, (uint64)capacity*4*sizeof(sgl_sprite_vertex), 0, "SGL Sprite Vertices");
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(sgl_sprite_vertex), (const void*)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(sgl_sprite_vertex), (const void*)(2*sizeof(float)));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sgl_sprite_vertex), (const void*)(4*sizeof(float)));
+
+    for(uint32 quad = 0; quad < capacity; ++quad)
+    {
+        uint32* quad_indices = indices + quad*6;
+        quad_indices[0] = quad*4 + 0;
+        quad_indices[1] = quad*4 + 1;
+        quad_indices[2] = quad*4 + 2;
+        quad_indices[3] = quad*4 + 0;
+        quad_indices[4] = quad*4 + 2;
+        quad_indices[5] = quad*4 + 3;
+    }
+    glGenBuffers(1, &batch->index_buffer);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, capacity*6*sizeof(uint32), indices, GL_STATIC_DRAW);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, batch->index_buffer, (uint64)capacity*6*sizeof(uint32), GL_UNSIGNED_INT, "SGL Sprite Indices");
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    sgl_internal_free(indices);
+    sgl_debug_label(GL_BUFFER, batch->vertex_buffer, "SGL Sprite Vertices");
+
+    const uint32 white = 0xFFFFFFFF;
+    batch->white_texture = sgl_internal_texture_create(1, 1, GL_RGBA8, GL_RGBA, &white);
+    sgl_debug_label(GL_TEXTURE, batch->white_texture, "SGL Sprite White");
+    return true;
+}
+
+void
+sgl_sprite_batch_free(SGLSpriteBatch* batch)
+{
+    sgl_internal_program_delete(&batch->program);
+    glDeleteVertexArrays(1, &batch->vertex_array);
+    sgl_internal_buffer_delete(&batch->vertex_buffer);
+    sgl_internal_buffer_delete(&batch->index_buffer);
+    sgl_internal_texture_delete(&batch->white_texture);
+    sgl_internal_free(batch->sprites);
+    *batch = {};
+}
+
+void
+sgl_sprite_batch_begin(SGLSpriteBatch* batch, int32 viewport_width, int32 viewport_height)
+{
+    batch->count = 0;
+    batch->bucket_count = 0;
+    batch->last_bucket = 0;
+    batch->layer = 0;
+    batch->blend = SGL_BLEND_ALPHA;
+    batch->viewport_width  = viewport_width;
+    batch->viewport_height = viewport_height;
+    batch->draw_calls = 0;
+    batch->sprites_drawn = 0;
+}
+
+void
+sgl_sprite_batch_set_layer(SGLSpriteBatch* batch, int32 layer)
+{
+    batch->layer = layer;
+}
+
+void
+sgl_sprite_batch_set_blend(SGLSpriteBatch* batch, SGLBlendMode blend)
+{
+    batch->blend = blend;
+}
+
+//[INTERNAL] The caller's blending, put back after we've switched it around for our own draws.
+struct sgl_blend_state {
+    GLboolean enabled;
+    GLint src_rgb;
+    GLint dst_rgb;
+    GLint src_alpha;
+    GLint dst_alpha;
+};
+
+internal void
+sgl_internal_blend_save(sgl_blend_state* state)
+{
+    state->enabled = glIsEnabled(GL_BLEND);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &state->src_rgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &state->dst_rgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &state->src_alpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &state->dst_alpha);
+}
+
+internal void
+sgl_internal_blend_restore(sgl_blend_state* state)
+{
+    if(state->enabled) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+    glBlendFuncSeparate((GLenum)state->src_rgb, (GLenum)state->dst_rgb, (GLenum)state->src_alpha, (GLenum)state->dst_alpha);
+}
+
+internal void
+sgl_internal_set_blend(SGLBlendMode blend)
+{
+    switch(blend)
+    {
+        case SGL_BLEND_ALPHA:         glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); break;
+        case SGL_BLEND_PREMULTIPLIED: glEnable(GL_BLEND); glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA); break;
+        case SGL_BLEND_ADDITIVE:      glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE); break;
+        case SGL_BLEND_OPAQUE:        glDisable(GL_BLEND); break;
+        InvalidDefaultCase;
+    }
+}
+
+//@NOTE: Writes the 4 vertices of every sprite, in bucket order, straight into the mapped buffer.
+internal void
+sgl_internal_sprite_write_vertices(SGLSpriteBatch* batch, sgl_sprite_vertex* vertices)
+{
+    uint32 cursor[SGL_SPRITE_MAX_BUCKETS];
+    for(uint32 bucket = 0; bucket < batch->bucket_count; ++bucket)
+    {
+        cursor[bucket] = batch->buckets[bucket].first;
+    }
+
+#if SGL_SSE2
+    //Lanes are (x, y, u, v). Corner 1 takes x/u from the far corner, corner 3 takes y/v.
+    const __m128 far_x_mask = _mm_castsi128_ps(_mm_set_epi32(0, -1, 0, -1));
+#endif
+    for(uint32 index = 0; index < batch->count; ++index)
+    {
+        sgl_sprite* sprite = &batch->sprites[index];
+        sgl_sprite_vertex* quad = vertices + 4*cursor[sprite->bucket]++;
+#if SGL_SSE2
+        __m128 rect = _mm_load_ps(sprite->rect);
+        __m128 uv   = _mm_load_ps(sprite->uv);
+        __m128 near_corner = _mm_movelh_ps(rect, uv);                                       //x,     y,     u0, v0
+        __m128 far_corner  = _mm_movelh_ps(_mm_add_ps(rect, _mm_movehl_ps(rect, rect)),
+                                           _mm_movehl_ps(uv, uv));                          //x + w, y + h, u1, v1
+        __m128 corner_1 = _mm_or_ps(_mm_and_ps(far_x_mask, far_corner), _mm_andnot_ps(far_x_mask, near_corner));
+        __m128 corner_3 = _mm_or_ps(_mm_andnot_ps(far_x_mask, far_corner), _mm_and_ps(far_x_mask, near_corner));
+        _mm_storeu_ps(quad[0].position, near_corner);
+        _mm_storeu_ps(quad[1].position, corner_1);
+        _mm_storeu_ps(quad[2].position, far_corner);
+        _mm_storeu_ps(quad[3].position, corner_3);
+#else
+        float x0 = sprite->rect[0], y0 = sprite->rect[1];
+        float x1 = x0 + sprite->rect[2], y1 = y0 + sprite->rect[3];
+        float u0 = sprite->uv[0], v0 = sprite->uv[1], u1 = sprite->uv[2], v1 = sprite->uv[3];
+        quad[0].position[0] = x0; quad[0].position[1] = y0; quad[0].uv[0] = u0; quad[0].uv[1] = v0;
+        quad[1].position[0] = x1; quad[1].position[1] = y0; quad[1].uv[0] = u1; quad[1].uv[1] = v0;
+        quad[2].position[0] = x1; quad[2].position[1] = y1; quad[2].uv[0] = u1; quad[2].uv[1] = v1;
+        quad[3].position[0] = x0; quad[3].position[1] = y1; quad[3].uv[0] = u0; quad[3].uv[1] = v1;
+#endif
+        quad[0].color = sprite->color;
+        quad[1].color = sprite->color;
+        quad[2].color = sprite->color;
+        quad[3].color = sprite->color;
+    }
+}
+
+internal void
+sgl_internal_sprite_batch_flush(SGLSpriteBatch* batch)
+{
+    if(!batch->count)
+    {
+        return;
+    }
+
+    //Draw order : by layer, then by first use. Insertion sort, there are only a handful of buckets.
+    uint32 order[SGL_SPRITE_MAX_BUCKETS];
+    for(uint32 bucket = 0; bucket < batch->bucket_count; ++bucket)
+    {
+        uint32 position = bucket;
+        while(position > 0 && batch->buckets[order[position - 1]].layer > batch->buckets[bucket].layer)
+        {
+            order[position] = order[position - 1];
+            --position;
+        }
+        order[position] = bucket;
+    }
+    uint32 first = 0;
+    for(uint32 position = 0; position < batch->bucket_count; ++position)
+    {
+        sgl_sprite_bucket* bucket = &batch->buckets[order[position]];
+        bucket->first = first;
+        first += bucket->count;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch->vertex_buffer);
+    GLsizeiptr size = batch->count*4*sizeof(sgl_sprite_vertex);
+    //@NOTE: Invalidating the whole buffer lets the driver hand us fresh memory (orphaning) instead of
+    //waiting for the previous flush's draws to finish.
+    sgl_sprite_vertex* vertices = (sgl_sprite_vertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size,
+                                                                       GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_BUFFER_BIT);
+    if(!vertices)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        batch->count = 0;
+        batch->bucket_count = 0;
+        return;
+    }
+    sgl_internal_sprite_write_vertices(batch, vertices);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+    GLboolean cull_face  = glIsEnabled(GL_CULL_FACE);
+    sgl_blend_state blend;
+    sgl_internal_blend_save(&blend);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_CULL_FACE);
+
+    glUseProgram(batch->program);
+    glUniform2f(batch->viewport_location, (GLfloat)batch->viewport_width, (GLfloat)batch->viewport_height);
+    glUniform1i(batch->texture_location, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindVertexArray(batch->vertex_array);
+
+    GLuint bound_texture = 0;
+    int32 bound_blend = -1;
+    for(uint32 position = 0; position < batch->bucket_count; ++position)
+    {
+        sgl_sprite_bucket* bucket = &batch->buckets[order[position]];
+        if(bucket->texture != bound_texture)
+        {
+            glBindTexture(GL_TEXTURE_2D, bucket->texture);
+            bound_texture = bucket->texture;
+        }
+        if((int32)bucket->blend != bound_blend)
+        {
+            sgl_internal_set_blend(bucket->blend);
+            bound_blend = (int32)bucket->blend;
+        }
+        glDrawElements(GL_TRIANGLES, bucket->count*6, GL_UNSIGNED_INT, (const void*)(size_t)(bucket->first*6*sizeof(uint32)));
+        ++batch->draw_calls;
+    }
+    batch->sprites_drawn += batch->count;
+
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    if(depth_test) glEnable(GL_DEPTH_TEST);
+    if(cull_face)  glEnable(GL_CULL_FACE);
+    sgl_internal_blend_restore(&blend);
+
+    batch->count = 0;
+    batch->bucket_count = 0;
+    batch->last_bucket = 0;
+}
+
+internal uint32
+sgl_internal_sprite_bucket(SGLSpriteBatch* batch, GLuint texture)
+{
+    //Almost every sprite goes into the same bucket as the one before it.
+    if(batch->last_bucket < batch->bucket_count)
+    {
+        sgl_sprite_bucket* last = &batch->buckets[batch->last_bucket];
+        if(last->texture == texture && last->layer == batch->layer && last->blend == batch->blend)
+        {
+            return batch->last_bucket;
+        }
+    }
+    for(uint32 index = 0; index < batch->bucket_count; ++index)
+    {
+        sgl_sprite_bucket* bucket = &batch->buckets[index];
+        if(bucket->texture == texture && bucket->layer == batch->layer && bucket->blend == batch->blend)
+        {
+            batch->last_bucket = index;
+            return index;
+        }
+    }
+    if(batch->bucket_count == SGL_SPRITE_MAX_BUCKETS)
+    {
+        sgl_internal_sprite_batch_flush(batch);
+    }
+    uint32 index = batch->bucket_count++;
+    sgl_sprite_bucket* bucket = &batch->buckets[index];
+    bucket->layer   = batch->layer;
+    bucket->texture = texture;
+    bucket->blend   = batch->blend;
+    bucket->count   = 0;
+    batch->last_bucket = index;
+    return index;
+}
+
+void
+sgl_sprite_draw_uv(SGLSpriteBatch* batch, GLuint texture, float x, float y, float width, float height,
+                   float u0, float v0, float u1, float v1, uint32 color)
+{
+    if(batch->count == batch->capacity)
+    {
+        sgl_internal_sprite_batch_flush(batch);
+    }
+    uint32 bucket = sgl_internal_sprite_bucket(batch, texture);
+    ++batch->buckets[bucket].count;
+
+    sgl_sprite* sprite = &batch->sprites[batch->count++];
+    sprite->rect[0] = x;
+    sprite->rect[1] = y;
+    sprite->rect[2] = width;
+    sprite->rect[3] = height;
+    sprite->uv[0] = u0;
+    sprite->uv[1] = v0;
+    sprite->uv[2] = u1;
+    sprite->uv[3] = v1;
+    sprite->color = color;
+    sprite->bucket = bucket;
+}
+
+void
+sgl_sprite_draw(SGLSpriteBatch* batch, SGLSpriteRegion* region, float x, float y, float width, float height, uint32 color)
+{
+    sgl_sprite_draw_uv(batch, region->texture, x, y, width, height, region->u0, region->v0, region->u1, region->v1, color);
+}
+
+void
+sgl_sprite_draw_rect(SGLSpriteBatch* batch, float x, float y, float width, float height, uint32 color)
+{
+    sgl_sprite_draw_uv(batch, batch->white_texture, x, y, width, height, 0.0f, 0.0f, 1.0f, 1.0f, color);
+}
+
+void
+sgl_sprite_batch_end(SGLSpriteBatch* batch)
+{
+    sgl_internal_sprite_batch_flush(batch);
+}
+
+//[END Sprite Batching] ---------------------
+
+//
+//[Text] ---------------------
+
+char* sgl_text_vertex_shader =
+ "#version 330                                                      \n"
+ "//Text VERT                                                       \n"
+ "layout (location = 0) in vec2 position;                           \n"
+ "layout (location = 1) in vec4 atlas_rect;                         \n"
+ "layout (location = 2) in vec4 color;                              \n"
+ "uniform vec2 viewport;                                            \n"
+ "out vec2 frag_texel;                                              \n"
+ "out vec4 frag_color;                                              \n"
+ "void main()                                                       \n"
+ "{                                                                 \n"
+ "    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);        \n"
+ "    vec2 ndc = (position + corner*atlas_rect.zw)/viewport*2.0 - 1.0; \n"
+ "    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);                  \n"
+ "    frag_texel = atlas_rect.xy + corner*atlas_rect.zw;            \n"
+ "    frag_color = color;                                           \n"
+ "}                                                                 \n";
+
+char* sgl_text_frag_shader =
+ "#version 330                                                      \n"
+ "//Text FRAG                                                       \n"
+ "in vec2 frag_texel;                                               \n"
+ "in vec4 frag_color;                                               \n"
+ "uniform sampler2D atlas;                                          \n"
+ "out vec4 color;                                                   \n"
+ "void main()                                                       \n"
+ "{                                                                 \n"
+ "    float coverage = texelFetch(atlas, ivec2(frag_texel), 0).r;   \n"
+ "    color = vec4(frag_color.rgb, frag_color.a*coverage);          \n"
+ "}                                                                 \n";
+
+#define SGL_TEXT_SCRATCH_SIZE   (256*256)
+//Shelf value of a glyph too big for the scratch bitmap or the atlas, it's skipped instead of re-rasterised every draw.
+#define SGL_TEXT_GLYPH_UNPLACEABLE -2
+//What sgl_internal_text_glyph_find returns once the glyph cache is at its load limit.
+#define SGL_TEXT_NO_GLYPH 0xFFFFFFFF
+#define SGL_TEXT_ATLAS_WIDTH    1024
+
+bool32
+sgl_text_create(SGLTextRenderer* text, uint32 instance_capacity)
+{
+    *text = {};
+    GLint max_size = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size);
+    text->atlas_width      = SGL_TEXT_ATLAS_WIDTH;
+    text->atlas_height     = 256;
+    text->atlas_max_height = max_size < 4096 ? (max_size > 256 ? max_size : 256) : 4096;
+    text->selected_font    = -1;
+    text->instance_capacity = instance_capacity;
+
+    text->dc           = CreateCompatibleDC(0);
+    text->glyphs       = (SGLGlyph*)sgl_internal_alloc(SGL_TEXT_GLYPH_CACHE_SIZE*sizeof(SGLGlyph));
+    text->runs         = (sgl_text_run*)sgl_internal_alloc(SGL_TEXT_RUN_CACHE_SIZE*sizeof(sgl_text_run));
+    text->arena        = (uint8*)sgl_internal_alloc(SGL_TEXT_RUN_ARENA_SIZE);
+    text->atlas_pixels = (uint8*)sgl_internal_alloc(text->atlas_width*text->atlas_height);
+    text->scratch      = (uint8*)sgl_internal_alloc(SGL_TEXT_SCRATCH_SIZE);
+    text->instances    = (sgl_text_instance*)sgl_internal_alloc(instance_capacity*sizeof(sgl_text_instance));
+    if(!text->dc || !text->glyphs || !text->runs || !text->arena || !text->atlas_pixels || !text->scratch || !text->instances)
+    {
+        sgl_text_free(text);
+        return false;
+    }
+    SetTextAlign(text->dc, TA_BASELINE);
+
+    text->atlas = sgl_internal_texture_create(text->atlas_width, text->atlas_height, GL_R8, GL_RED, text->atlas_pixels);
+    sgl_debug_label(GL_TEXTURE, text->atlas, "SGL Glyph Atlas");
+
+    GLuint shader_list[2] = 
+    {
+        sgl_internal_shader_create(GL_VERTEX_SHADER, sgl_text_vertex_shader),
+        sgl_internal_shader_create(GL_FRAGMENT_SHADER, sgl_text_frag_shader)
+    };
+    text->program = sgl_internal_program_create(shader_list, 2, "SGL Text");
+    glDeleteShader(shader_list[0]);
+    glDeleteShader(shader_list[1]);
+    text->viewport_location = glGetUniformLocation(text->program, "viewport");
+    text->texture_location  = glGetUniformLocation(text->program, "atlas");
+
+    //No per vertex data, the corners come from gl_VertexID.
+    glGenVertexArrays(1, &text->vertex_array);
+    glBindVertexArray(text->vertex_array);
+    glGenBuffers(1, &text->instance_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, text->instance_buffer);
+    glBufferData(GL_ARRAY_BUFFER, instance_capacity*sizeof(sgl_text_instance), 0, GL_STREAM_DRAW);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, text->instance_buffer, (uint64)instance_capacity*sizeof(sgl_text_instance), 0, "SGL Text Instances");
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(sgl_text_instance), (const void*)0);
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(sgl_text_instance), (const void*)(2*sizeof(float)));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(sgl_text_instance), (const void*)(2*sizeof(float) + 4*sizeof(uint16)));
+    glVertexAttribDivisor(2, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    sgl_debug_label(GL_BUFFER, text->instance_buffer, "SGL Text Instances");
+    return true;
+}
+
+void
+sgl_text_free(SGLTextRenderer* text)
+{
+    for(int32 font = 0; font < text->font_count; ++font)
+    {
+        DeleteObject(text->fonts[font].handle);
+    }
+    if(text->dc)
+    {
+        DeleteDC(text->dc);
+    }
+    if(text->program)
+    {
+        sgl_internal_program_delete(&text->program);
+        glDeleteVertexArrays(1, &text->vertex_array);
+        sgl_internal_buffer_delete(&text->instance_buffer);
+        sgl_internal_texture_delete(&text->atlas);
+    }
+    sgl_internal_free(text->glyphs);
+    sgl_internal_free(text->runs);
+    sgl_internal_free(text->arena);
+    sgl_internal_free(text->atlas_pixels);
+    sgl_internal_free(text->scratch);
+    sgl_internal_free(text->instances);
+    *text = {};
+}
+
+int32
+sgl_text_font_add(SGLTextRenderer* text, const char* face, int32 pixel_height, int32 weight)
+{
+    if(text->font_count == SGL_TEXT_MAX_FONTS)
+    {
+        return -1;
+    }
+    HFONT handle = CreateFontA(-pixel_height, 0, 0, 0, weight, FALSE, FALSE, FALSE, DEFAULT_CHARSET, OUT_TT_PRECIS,
+                               CLIP_DEFAULT_PRECIS, ANTIALIASED_QUALITY, DEFAULT_PITCH|FF_DONTCARE, face);
+    if(!handle)
+    {
+        return -1;
+    }
+    int32 index = text->font_count++;
+    SelectObject(text->dc, handle);
+    text->selected_font = index;
+    TEXTMETRICA metrics;
+    GetTextMetricsA(text->dc, &metrics);
+
+    SGLFont* font = &text->fonts[index];
+    font->handle       = handle;
+    font->pixel_height = pixel_height;
+    font->ascent       = metrics.tmAscent;
+    font->line_height  = metrics.tmHeight + metrics.tmExternalLeading;
+    return index;
+}
+
+//Forgets every glyph and run, the atlas gets packed from scratch.
+internal void
+sgl_internal_text_cache_reset(SGLTextRenderer* text)
+{
+    memset(text->glyphs, 0, SGL_TEXT_GLYPH_CACHE_SIZE*sizeof(SGLGlyph));
+    memset(text->runs, 0, SGL_TEXT_RUN_CACHE_SIZE*sizeof(sgl_text_run));
+    text->glyph_count = 0;
+    text->run_count = 0;
+    text->arena_used = 0;
+    text->shelf_count = 0;
+    text->shelf_bottom = 0;
+}
+
+internal void
+sgl_internal_text_runs_reset(SGLTextRenderer* text)
+{
+    memset(text->runs, 0, SGL_TEXT_RUN_CACHE_SIZE*sizeof(sgl_text_run));
+    text->run_count = 0;
+    text->arena_used = 0;
+}
+
+//@NOTE: Doubles the atlas height. Glyph coordinates are in texels so nothing already placed moves,
+//the texture is re-specified from the CPU copy.
+internal bool32
+sgl_internal_text_atlas_grow(SGLTextRenderer* text)
+{
+    if(text->atlas_height >= text->atlas_max_height)
+    {
+        return false;
+    }
+    int32 height = text->atlas_height*2;
+    if(height > text->atlas_max_height)
+    {
+        height = text->atlas_max_height;
+    }
+    uint8* pixels = (uint8*)sgl_internal_alloc(text->atlas_width*height);
+    if(!pixels)
+    {
+        return false;
+    }
+    memcpy(pixels, text->atlas_pixels, text->atlas_width*text->atlas_height);
+    sgl_internal_free(text->atlas_pixels);
+    text->atlas_pixels = pixels;
+    text->atlas_height = height;
+
+    glBindTexture(GL_TEXTURE_2D, text->atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, text->atlas_width, text->atlas_height, 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    SGL_GPU_TRACK(SGL_GPU_TEXTURE, text->atlas, (uint64)text->atlas_width*text->atlas_height, GL_R8, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+//Finds room for a width x height box : best fitting shelf, then a new shelf, then a bigger atlas, then
+//the least recently used shelf that wasn't touched this frame. Returns the shelf or -1.
+internal int32
+sgl_internal_text_shelf_alloc(SGLTextRenderer* text, int32 width, int32 height)
+{
+    for(;;)
+    {
+        int32 best = -1;
+        for(int32 index = 0; index < text->shelf_count; ++index)
+        {
+            sgl_text_shelf* shelf = &text->shelves[index];
+            if(shelf->height >= height && shelf->height <= height + height/2 + 2 &&
+               shelf->cursor + width <= text->atlas_width &&
+               (best < 0 || shelf->height < text->shelves[best].height))
+            {
+                best = index;
+            }
+        }
+        if(best >= 0)
+        {
+            return best;
+        }
+
+        //Shelves are rounded up so glyphs of close sizes share them.
+        int32 shelf_height = (height + 3) & ~3;
+        if(text->shelf_count < SGL_TEXT_MAX_SHELVES && text->shelf_bottom + shelf_height <= text->atlas_height)
+        {
+            sgl_text_shelf* shelf = &text->shelves[text->shelf_count];
+            shelf->y = text->shelf_bottom;
+            shelf->height = shelf_height;
+            shelf->cursor = 0;
+            shelf->last_used = text->frame;
+            text->shelf_bottom += shelf_height;
+            return text->shelf_count++;
+        }
+
+        if(text->shelf_count == SGL_TEXT_MAX_SHELVES || !sgl_internal_text_atlas_grow(text))
+        {
+            break;
+        }
+    }
+
+    int32 victim = -1;
+    for(int32 index = 0; index < text->shelf_count; ++index)
+    {
+        sgl_text_shelf* shelf = &text->shelves[index];
+        if(shelf->height >= height && shelf->last_used != text->frame &&
+           (victim < 0 || shelf->last_used < text->shelves[victim].last_used))
+        {
+            victim = index;
+        }
+    }
+    if(victim < 0)
+    {
+        if(!text->instance_count)
+        {
+            return -1;
+        }
+        //This frame's text alone fills the atlas : draw what we have so every shelf can be recycled.
+        sgl_text_end(text);
+        ++text->frame;
+        return sgl_internal_text_shelf_alloc(text, width, height);
+    }
+    for(uint32 index = 0; index < SGL_TEXT_GLYPH_CACHE_SIZE; ++index)
+    {
+        if(text->glyphs[index].key && text->glyphs[index].shelf == victim)
+        {
+            text->glyphs[index].shelf = -1;
+        }
+    }
+    text->shelves[victim].cursor = 0;
+    return victim;
+}
+
+//@NOTE: Rasterises the glyph with GDI and fills its metrics. If it has pixels and place is true they
+//are packed into the atlas and uploaded.
+internal void
+sgl_internal_text_glyph_rasterize(SGLTextRenderer* text, SGLGlyph* glyph, bool32 place)
+{
+    int32 font = (int32)(glyph->key >> 21) - 1;
+    uint32 codepoint = glyph->key & 0x1FFFFF;
+    if(text->selected_font != font)
+    {
+        SelectObject(text->dc, text->fonts[font].handle);
+        text->selected_font = font;
+    }
+
+    MAT2 identity = {{0, 1}, {0, 0}, {0, 0}, {0, 1}};
+    GLYPHMETRICS metrics;
+    DWORD size = GetGlyphOutlineW(text->dc, codepoint, GGO_GRAY8_BITMAP, &metrics, 0, 0, &identity);
+    glyph->shelf = -1;
+    if(size == GDI_ERROR)
+    {
+        glyph->width = 0;
+        glyph->height = 0;
+        glyph->advance = 0.0f;
+        return;
+    }
+    glyph->advance   = (float)metrics.gmCellIncX;
+    glyph->bearing_x = (int16)metrics.gmptGlyphOrigin.x;
+    glyph->bearing_y = (int16)metrics.gmptGlyphOrigin.y;
+    //Blank glyphs report a 1x1 black box and no bitmap.
+    glyph->width  = size ? (uint16)metrics.gmBlackBoxX : 0;
+    glyph->height = size ? (uint16)metrics.gmBlackBoxY : 0;
+    if(size > SGL_TEXT_SCRATCH_SIZE || glyph->width + 1 > text->atlas_width)
+    {
+        glyph->shelf = SGL_TEXT_GLYPH_UNPLACEABLE;
+        return;
+    }
+    if(!size || !place)
+    {
+        return;
+    }
+
+    int32 shelf_index = sgl_internal_text_shelf_alloc(text, glyph->width + 1, glyph->height + 1);
+    if(shelf_index < 0)
+    {
+        return;
+    }
+    GetGlyphOutlineW(text->dc, codepoint, GGO_GRAY8_BITMAP, &metrics, size, text->scratch, &identity);
+
+    sgl_text_shelf* shelf = &text->shelves[shelf_index];
+    glyph->shelf   = shelf_index;
+    glyph->atlas_x = (int16)shelf->cursor;
+    glyph->atlas_y = (int16)shelf->y;
+    shelf->cursor += glyph->width + 1;
+    shelf->last_used = text->frame;
+
+    //GDI gives 65 levels (0-64) with rows padded to 4 bytes.
+    uint32 pitch = (glyph->width + 3) & ~3;
+    for(uint32 row = 0; row < glyph->height; ++row)
+    {
+        uint8* source = text->scratch + row*pitch;
+        uint8* destination = text->atlas_pixels + (glyph->atlas_y + row)*text->atlas_width + glyph->atlas_x;
+        for(uint32 column = 0; column < glyph->width; ++column)
+        {
+            destination[column] = (uint8)((source[column]*255 + 32) >> 6);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, text->atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, text->atlas_width);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, glyph->atlas_x, glyph->atlas_y, glyph->width, glyph->height, GL_RED, GL_UNSIGNED_BYTE,
+                    text->atlas_pixels + glyph->atlas_y*text->atlas_width + glyph->atlas_x);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    ++text->glyphs_rasterized;
+}
+
+internal uint32
+sgl_internal_text_glyph_find(SGLTextRenderer* text, int32 font, uint32 codepoint)
+{
+    uint32 key = ((uint32)(font + 1) << 21) | codepoint;
+    uint32 mask = SGL_TEXT_GLYPH_CACHE_SIZE - 1;
+    uint32 slot = (key*2654435761u) & mask;
+    //The load limit keeps empty slots around, so the probe always ends; the bound is just belt and braces.
+    for(uint32 probe = 0; text->glyphs[slot].key && text->glyphs[slot].key != key; ++probe)
+    {
+        if(probe == mask)
+        {
+            return SGL_TEXT_NO_GLYPH;
+        }
+        slot = (slot + 1) & mask;
+    }
+    SGLGlyph* glyph = &text->glyphs[slot];
+    if(!glyph->key)
+    {
+        //Runs hold glyph indices, so the cache can't be reset halfway through a layout. Let the caller give up.
+        if(text->glyph_count >= SGL_TEXT_GLYPH_CACHE_SIZE*3/4)
+        {
+            return SGL_TEXT_NO_GLYPH;
+        }
+        glyph->key = key;
+        ++text->glyph_count;
+        sgl_internal_text_glyph_rasterize(text, glyph, true);
+    }
+    return slot;
+}
+
+internal uint32
+sgl_internal_utf8_decode(const uint8** cursor)
+{
+    const uint8* c = *cursor;
+    uint32 codepoint;
+    if(c[0] < 0x80)
+    {
+        codepoint = c[0];
+        *cursor += 1;
+    }
+    else if((c[0] & 0xE0) == 0xC0 && c[1])
+    {
+        codepoint = ((c[0] & 0x1F) << 6) | (c[1] & 0x3F);
+        *cursor += 2;
+    }
+    else if((c[0] & 0xF0) == 0xE0 && c[1] && c[2])
+    {
+        codepoint = ((c[0] & 0x0F) << 12) | ((c[1] & 0x3F) << 6) | (c[2] & 0x3F);
+        *cursor += 3;
+    }
+    else if((c[0] & 0xF8) == 0xF0 && c[1] && c[2] && c[3])
+    {
+        codepoint = ((c[0] & 0x07) << 18) | ((c[1] & 0x3F) << 12) | ((c[2] & 0x3F) << 6) | (c[3] & 0x3F);
+        *cursor += 4;
+    }
+    else
+    {
+        codepoint = 0xFFFD;
+        *cursor += 1;
+    }
+    return codepoint;
+}
+
+//Returns the cached run for (font, string), laying it out on a miss. 0 if the string can't fit the cache.
+internal sgl_text_run*
+sgl_internal_text_run(SGLTextRenderer* text, int32 font, const char* string)
+{
+    uint32 length = (uint32)strlen(string);
+    uint32 hash = sgl_internal_hash32(string, length, 2166136261u ^ (uint32)font*16777619u) | 1;
+
+    uint32 mask = SGL_TEXT_RUN_CACHE_SIZE - 1;
+    uint32 slot = hash & mask;
+    for(sgl_text_run* run = &text->runs[slot]; run->hash; run = &text->runs[slot = (slot + 1) & mask])
+    {
+        if(run->hash == hash && run->font == font && run->length == length &&
+           !memcmp(text->arena + run->string_offset, string, length))
+        {
+            return run;
+        }
+    }
+
+    //Miss. A byte is at most one glyph, so this is enough room for anything the layout adds.
+    uint32 glyph_bytes = length*sizeof(sgl_text_run_glyph);
+    uint32 needed = ((length + 3) & ~3) + glyph_bytes;
+    if(needed > SGL_TEXT_RUN_ARENA_SIZE)
+    {
+        return 0;
+    }
+    if(text->glyph_count + length > SGL_TEXT_GLYPH_CACHE_SIZE*3/4)
+    {
+        //Everything drawn so far this frame points at atlas space that's about to be reused.
+        sgl_text_end(text);
+        sgl_internal_text_cache_reset(text);
+    }
+    if(text->arena_used + needed > SGL_TEXT_RUN_ARENA_SIZE || text->run_count + 1 > SGL_TEXT_RUN_CACHE_SIZE*3/4)
+    {
+        sgl_internal_text_runs_reset(text);
+    }
+    slot = hash & mask;
+    while(text->runs[slot].hash)
+    {
+        slot = (slot + 1) & mask;
+    }
+
+    sgl_text_run* run = &text->runs[slot];
+    run->hash = hash;
+    run->font = font;
+    run->length = length;
+    run->string_offset = text->arena_used;
+    memcpy(text->arena + text->arena_used, string, length);
+    text->arena_used += (length + 3) & ~3;
+    run->glyph_offset = text->arena_used;
+    run->glyph_count = 0;
+    ++text->run_count;
+    ++text->runs_built;
+
+    SGLFont* font_info = &text->fonts[font];
+    sgl_text_run_glyph* glyphs = (sgl_text_run_glyph*)(text->arena + run->glyph_offset);
+    float pen_x = 0.0f;
+    float pen_y = 0.0f;
+    float width = 0.0f;
+    const uint8* cursor = (const uint8*)string;
+    while(*cursor)
+    {
+        uint32 codepoint = sgl_internal_utf8_decode(&cursor);
+        if(codepoint == '\n')
+        {
+            pen_x = 0.0f;
+            pen_y += (float)font_info->line_height;
+            continue;
+        }
+        if(codepoint > 0xFFFF)
+        {
+            continue;
+        }
+        uint32 index = sgl_internal_text_glyph_find(text, font, codepoint);
+        if(index == SGL_TEXT_NO_GLYPH)
+        {
+            //More distinct glyphs than the cache holds even right after a reset, drop the run.
+            run->hash = 0;
+            --text->run_count;
+            text->arena_used = run->string_offset;
+            return 0;
+        }
+        SGLGlyph* glyph = &text->glyphs[index];
+        if(glyph->width)
+        {
+            sgl_text_run_glyph* run_glyph = &glyphs[run->glyph_count++];
+            run_glyph->x = pen_x + glyph->bearing_x;
+            run_glyph->y = pen_y + font_info->ascent - glyph->bearing_y;
+            run_glyph->glyph = index;
+        }
+        pen_x += glyph->advance;
+        if(pen_x > width)
+        {
+            width = pen_x;
+        }
+    }
+    run->width = width;
+    run->height = pen_y + font_info->line_height;
+    text->arena_used += run->glyph_count*sizeof(sgl_text_run_glyph);
+    return run;
+}
+
+void
+sgl_text_begin(SGLTextRenderer* text, int32 viewport_width, int32 viewport_height)
+{
+    ++text->frame;
+    text->instance_count  = 0;
+    text->viewport_width  = viewport_width;
+    text->viewport_height = viewport_height;
+    text->draw_calls   = 0;
+    text->glyphs_drawn = 0;
+}
+
+void
+sgl_text_draw(SGLTextRenderer* text, int32 font, float x, float y, const char* string, uint32 color)
+{
+    sgl_text_run* run = sgl_internal_text_run(text, font, string);
+    if(!run)
+    {
+        return;
+    }
+    //Snap to the pixel grid, glyphs are fetched 1:1 from the atlas.
+    x = floorf(x + 0.5f);
+    y = floorf(y + 0.5f);
+    sgl_text_run_glyph* glyphs = (sgl_text_run_glyph*)(text->arena + run->glyph_offset);
+    for(uint32 index = 0; index < run->glyph_count; ++index)
+    {
+        SGLGlyph* glyph = &text->glyphs[glyphs[index].glyph];
+        if(glyph->shelf == SGL_TEXT_GLYPH_UNPLACEABLE)
+        {
+            continue;
+        }
+        if(glyph->shelf < 0)
+        {
+            //Evicted since the run was laid out.
+            sgl_internal_text_glyph_rasterize(text, glyph, true);
+            if(glyph->shelf < 0)
+            {
+                continue;
+            }
+        }
+        text->shelves[glyph->shelf].last_used = text->frame;
+
+        if(text->instance_count == text->instance_capacity)
+        {
+            sgl_text_end(text);
+        }
+        sgl_text_instance* instance = &text->instances[text->instance_count++];
+        instance->position[0] = x + glyphs[index].x;
+        instance->position[1] = y + glyphs[index].y;
+        instance->atlas[0] = (uint16)glyph->atlas_x;
+        instance->atlas[1] = (uint16)glyph->atlas_y;
+        instance->atlas[2] = glyph->width;
+        instance->atlas[3] = glyph->height;
+        instance->color = color;
+    }
+}
+
+void
+sgl_text_measure(SGLTextRenderer* text, int32 font, const char* string, float* width, float* height)
+{
+    sgl_text_run* run = sgl_internal_text_run(text, font, string);
+    *width  = run ? run->width : 0.0f;
+    *height = run ? run->height : 0.0f;
+}
+
+void
+sgl_text_end(SGLTextRenderer* text)
+{
+    if(!text->instance_count)
+    {
+        return;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, text->instance_buffer);
+    GLsizeiptr size = text->instance_count*sizeof(sgl_text_instance);
+    void* destination = glMapBufferRange(GL_ARRAY_BUFFER, 0, size, GL_MAP_WRITE_BIT|GL_MAP_INVALIDATE_BUFFER_BIT);
+    if(destination)
+    {
+        memcpy(destination, text->instances, size);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if(destination)
+    {
+        GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+        GLboolean cull_face  = glIsEnabled(GL_CULL_FACE);
+        sgl_blend_state blend;
+        sgl_internal_blend_save(&blend);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glUseProgram(text->program);
+        glUniform2f(text->viewport_location, (GLfloat)text->viewport_width, (GLfloat)text->viewport_height);
+        glUniform1i(text->texture_location, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, text->atlas);
+        glBindVertexArray(text->vertex_array);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, text->instance_count);
+        glBindVertexArray(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+
+        if(depth_test) glEnable(GL_DEPTH_TEST);
+        if(cull_face)  glEnable(GL_CULL_FACE);
+        sgl_internal_blend_restore(&blend);
+        ++text->draw_calls;
+        text->glyphs_drawn += text->instance_count;
+    }
+    text->instance_count = 0;
+}
+
+//[END Text] ---------------------
+
+//
+//[Render Targets] ---------------------
+
+internal bool32
+sgl_internal_format_is_depth(GLenum format)
+{
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH_COMPONENT24 || format == GL_DEPTH_COMPONENT32F ||
+           format == GL_DEPTH_COMPONENT;
+}
+
+#define sgl_internal_render_texture_create(desc) sgl_internal_render_texture_create_at(desc, __FUNCTION__, __LINE__)
+
+internal GLuint
+sgl_internal_render_texture_create_at(SGLTextureDesc desc, const char* function, int32 line)
+{
+    GLenum format = GL_RGBA;
+    GLenum type = GL_UNSIGNED_BYTE;
+    if(desc.format == GL_DEPTH24_STENCIL8)
+    {
+        format = GL_DEPTH_STENCIL;
+        type = GL_UNSIGNED_INT_24_8;
+    }
+    else if(sgl_internal_format_is_depth(desc.format))
+    {
+        format = GL_DEPTH_COMPONENT;
+        type = GL_FLOAT;
+    }
+    return sgl_internal_texture_create_at(function, line, desc.width, desc.height, desc.format, format, 0, type);
+}
+
+//@NOTE: colors can hold zeros (skipped attachment slots aren't allowed, they're packed), depth can be 0.
+internal GLuint
+sgl_internal_framebuffer_create(GLuint* colors, int32 color_count, GLuint depth, GLenum depth_format)
+{
+    GLuint framebuffer;
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    GLenum draw_buffers[SGL_RENDER_GRAPH_MAX_COLOR];
+    for(int32 index = 0; index < color_count; ++index)
+    {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + index, GL_TEXTURE_2D, colors[index], 0);
+        draw_buffers[index] = GL_COLOR_ATTACHMENT0 + index;
+    }
+    if(depth)
+    {
+        GLenum attachment = depth_format == GL_DEPTH24_STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, depth, 0);
+    }
+    if(color_count)
+    {
+        glDrawBuffers(color_count, draw_buffers);
+    }
+    else
+    {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+    if(glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+        return 0;
+    }
+    return framebuffer;
+}
+
+bool32
+sgl_render_target_create(SGLRenderTarget* target, int32 width, int32 height, GLenum color_format, GLenum depth_format)
+{
+    *target = {};
+    target->width = width;
+    target->height = height;
+    SGLTextureDesc desc = {width, height, color_format};
+    target->color = sgl_internal_render_texture_create(desc);
+    if(depth_format)
+    {
+        desc.format = depth_format;
+        target->depth = sgl_internal_render_texture_create(desc);
+    }
+    target->framebuffer = sgl_internal_framebuffer_create(&target->color, 1, target->depth, depth_format);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if(!target->framebuffer)
+    {
+        sgl_render_target_free(target);
+        return false;
+    }
+    return true;
+}
+
+void
+sgl_render_target_free(SGLRenderTarget* target)
+{
+    if(target->framebuffer)
+    {
+        glDeleteFramebuffers(1, &target->framebuffer);
+    }
+    sgl_internal_texture_delete(&target->color);
+    if(target->depth)
+    {
+        sgl_internal_texture_delete(&target->depth);
+    }
+    *target = {};
+}
+
+void
+sgl_render_target_bind(SGLRenderTarget* target)
+{
+    if(!target)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glViewport(0, 0, target->width, target->height);
+}
+
+//[END Render Targets] ---------------------
+
+//
+//[Render Graph] ---------------------
+
+void
+sgl_render_graph_create(SGLRenderGraph* graph)
+{
+    *graph = {};
+}
+
+void
+sgl_render_graph_free(SGLRenderGraph* graph)
+{
+    for(int32 index = 0; index < graph->framebuffer_count; ++index)
+    {
+        glDeleteFramebuffers(1, &graph->framebuffers[index].framebuffer);
+    }
+    for(int32 index = 0; index < graph->pool_count; ++index)
+    {
+        sgl_internal_texture_delete(&graph->pool[index].texture);
+    }
+    *graph = {};
+}
+
+void
+sgl_render_graph_begin(SGLRenderGraph* graph)
+{
+    ++graph->frame;
+    graph->pass_count = 0;
+    graph->resource_count = 0;
+}
+
+internal SGLGraphResource
+sgl_internal_graph_resource_add(SGLRenderGraph* graph, const char* name, SGLTextureDesc desc, uint32 flags, GLuint texture)
+{
+    SGL_Assert(graph->resource_count < SGL_RENDER_GRAPH_MAX_RESOURCES);
+    SGLGraphResource handle = graph->resource_count++;
+    sgl_graph_resource* resource = &graph->resources[handle];
+    *resource = {};
+    resource->name     = name;
+    resource->desc     = desc;
+    resource->flags    = flags;
+    resource->texture  = texture;
+    return handle;
+}
+
+SGLGraphResource
+sgl_render_graph_create_texture(SGLRenderGraph* graph, const char* name, SGLTextureDesc desc)
+{
+    return sgl_internal_graph_resource_add(graph, name, desc, 0, 0);
+}
+
+SGLGraphResource
+sgl_render_graph_import_texture(SGLRenderGraph* graph, const char* name, GLuint texture, SGLTextureDesc desc)
+{
+    return sgl_internal_graph_resource_add(graph, name, desc, SGL_GRAPH_RESOURCE_EXTERNAL, texture);
+}
+
+SGLGraphResource
+sgl_render_graph_backbuffer(SGLRenderGraph* graph, int32 width, int32 height)
+{
+    SGLTextureDesc desc = {width, height, GL_RGBA8};
+    return sgl_internal_graph_resource_add(graph, "backbuffer", desc,
+                                           SGL_GRAPH_RESOURCE_EXTERNAL|SGL_GRAPH_RESOURCE_BACKBUFFER, 0);
+}
+
+int32
+sgl_render_graph_add_pass(SGLRenderGraph* graph, const char* name, sgl_render_pass_func* func, void* data)
+{
+    SGL_Assert(graph->pass_count < SGL_RENDER_GRAPH_MAX_PASSES);
+    int32 index = graph->pass_count++;
+    sgl_graph_pass* pass = &graph->passes[index];
+    *pass = {};
+    pass->name = name;
+    pass->func = func;
+    pass->data = data;
+    return index;
+}
+
+void
+sgl_render_graph_read(SGLRenderGraph* graph, int32 pass, SGLGraphResource resource)
+{
+    sgl_graph_pass* graph_pass = &graph->passes[pass];
+    SGL_Assert(graph_pass->read_count < SGL_RENDER_GRAPH_MAX_PASS_IO);
+    graph_pass->reads[graph_pass->read_count++] = resource;
+}
+
+bool32
+sgl_render_graph_write(SGLRenderGraph* graph, int32 pass, SGLGraphResource resource)
+{
+    sgl_graph_pass* graph_pass = &graph->passes[pass];
+    SGL_Assert(graph_pass->write_count < SGL_RENDER_GRAPH_MAX_PASS_IO);
+    //The backbuffer is framebuffer 0, nothing else can be attached next to it.
+    uint32 backbuffer = graph->resources[resource].flags & SGL_GRAPH_RESOURCE_BACKBUFFER;
+    for(int32 write = 0; write < graph_pass->write_count; ++write)
+    {
+        if((graph->resources[graph_pass->writes[write]].flags & SGL_GRAPH_RESOURCE_BACKBUFFER) != backbuffer)
+        {
+            fprintf(stderr, "SGL render graph : pass [%s] can't write [%s] together with [%s]\n", graph_pass->name,
+                    graph->resources[resource].name, graph->resources[graph_pass->writes[write]].name);
+            return false;
+        }
+    }
+    graph_pass->writes[graph_pass->write_count++] = resource;
+    return true;
+}
+
+void
+sgl_render_graph_clear(SGLRenderGraph* graph, int32 pass, GLbitfield mask, float r, float g, float b, float a)
+{
+    sgl_graph_pass* graph_pass = &graph->passes[pass];
+    graph_pass->clear_mask = mask;
+    graph_pass->clear_color[0] = r;
+    graph_pass->clear_color[1] = g;
+    graph_pass->clear_color[2] = b;
+    graph_pass->clear_color[3] = a;
+}
+
+GLuint
+sgl_render_graph_texture(SGLRenderGraph* graph, SGLGraphResource resource)
+{
+    return graph->resources[resource].texture;
+}
+
+//Walks the passes backwards : a pass lives if it writes something needed, and then what it reads is needed.
+internal void
+sgl_internal_graph_cull(SGLRenderGraph* graph)
+{
+    for(int32 index = 0; index < graph->resource_count; ++index)
+    {
+        sgl_graph_resource* resource = &graph->resources[index];
+        resource->needed = (resource->flags & SGL_GRAPH_RESOURCE_EXTERNAL) != 0;
+        resource->first_pass = -1;
+        resource->last_pass = -1;
+        resource->written = false;
+    }
+    for(int32 index = graph->pass_count - 1; index >= 0; --index)
+    {
+        sgl_graph_pass* pass = &graph->passes[index];
+        pass->live = false;
+        for(int32 write = 0; write < pass->write_count; ++write)
+        {
+            if(graph->resources[pass->writes[write]].needed)
+            {
+                pass->live = true;
+            }
+        }
+        if(pass->live)
+        {
+            for(int32 read = 0; read < pass->read_count; ++read)
+            {
+                graph->resources[pass->reads[read]].needed = true;
+            }
+        }
+    }
+
+    graph->stats.passes = graph->pass_count;
+    graph->stats.passes_culled = 0;
+    graph->stats.uninitialized_reads = 0;
+    for(int32 index = 0; index < graph->pass_count; ++index)
+    {
+        sgl_graph_pass* pass = &graph->passes[index];
+        if(!pass->live)
+        {
+            ++graph->stats.passes_culled;
+            continue;
+        }
+        //A transient read before anything wrote it gets whatever a pool texture held last.
+        for(int32 read = 0; read < pass->read_count; ++read)
+        {
+            sgl_graph_resource* resource = &graph->resources[pass->reads[read]];
+            if(!resource->written && !(resource->flags & SGL_GRAPH_RESOURCE_EXTERNAL))
+            {
+                ++graph->stats.uninitialized_reads;
+                if(!graph->warned_uninitialized)
+                {
+                    graph->warned_uninitialized = true;
+                    fprintf(stderr, "SGL render graph : pass [%s] reads [%s] before any live pass writes it\n",
+                            pass->name, resource->name);
+                }
+            }
+        }
+        for(int32 write = 0; write < pass->write_count; ++write)
+        {
+            graph->resources[pass->writes[write]].written = true;
+        }
+        for(int32 io = 0; io < pass->read_count + pass->write_count; ++io)
+        {
+            SGLGraphResource handle = io < pass->read_count ? pass->reads[io] : pass->writes[io - pass->read_count];
+            sgl_graph_resource* resource = &graph->resources[handle];
+            if(resource->first_pass < 0)
+            {
+                resource->first_pass = index;
+            }
+            resource->last_pass = index;
+        }
+    }
+}
+
+internal void
+sgl_internal_graph_framebuffers_release(SGLRenderGraph* graph, GLuint texture)
+{
+    for(int32 index = 0; index < graph->framebuffer_count; )
+    {
+        sgl_render_pool_framebuffer* framebuffer = &graph->framebuffers[index];
+        bool32 uses = false;
+        for(int32 attachment = 0; attachment < SGL_RENDER_GRAPH_MAX_COLOR + 1; ++attachment)
+        {
+            if(framebuffer->attachments[attachment] == texture)
+            {
+                uses = true;
+            }
+        }
+        if(uses)
+        {
+            glDeleteFramebuffers(1, &framebuffer->framebuffer);
+            graph->framebuffers[index] = graph->framebuffers[--graph->framebuffer_count];
+        }
+        else
+        {
+            ++index;
+        }
+    }
+}
+
+//@NOTE: Resources are visited in order of first use, so a pool texture whose current tenant's last pass
+//is before this resource's first pass is free for it.
+internal void
+sgl_internal_graph_allocate(SGLRenderGraph* graph)
+{
+    for(int32 index = 0; index < graph->pool_count; ++index)
+    {
+        graph->pool[index].busy_until = -1;
+    }
+    graph->stats.transient_textures = 0;
+    graph->stats.transient_bytes = 0;
+
+    for(int32 pass = 0; pass < graph->pass_count; ++pass)
+    {
+        if(!graph->passes[pass].live)
+        {
+            continue;
+        }
+        for(int32 handle = 0; handle < graph->resource_count; ++handle)
+        {
+            sgl_graph_resource* resource = &graph->resources[handle];
+            if(resource->first_pass != pass || (resource->flags & SGL_GRAPH_RESOURCE_EXTERNAL))
+            {
+                continue;
+            }
+            ++graph->stats.transient_textures;
+            graph->stats.transient_bytes += (uint64)resource->desc.width*resource->desc.height*sgl_internal_format_bytes(resource->desc.format);
+
+            int32 slot = -1;
+            for(int32 index = 0; index < graph->pool_count; ++index)
+            {
+                sgl_render_pool_texture* pooled = &graph->pool[index];
+                if(pooled->busy_until < pass && pooled->desc.width == resource->desc.width &&
+                   pooled->desc.height == resource->desc.height && pooled->desc.format == resource->desc.format)
+                {
+                    slot = index;
+                    break;
+                }
+            }
+            if(slot < 0)
+            {
+                SGL_Assert(graph->pool_count < SGL_RENDER_GRAPH_MAX_POOL);
+                slot = graph->pool_count++;
+                sgl_render_pool_texture* pooled = &graph->pool[slot];
+                pooled->desc = resource->desc;
+                pooled->texture = sgl_internal_render_texture_create(resource->desc);
+                sgl_debug_label(GL_TEXTURE, pooled->texture, "SGL Transient Target");
+            }
+            sgl_render_pool_texture* pooled = &graph->pool[slot];
+            pooled->busy_until = resource->last_pass;
+            pooled->last_frame = graph->frame;
+            resource->texture = pooled->texture;
+        }
+    }
+
+    //Textures nobody asked for in a while go away.
+    graph->stats.pool_bytes = 0;
+    for(int32 index = 0; index < graph->pool_count; )
+    {
+        sgl_render_pool_texture* pooled = &graph->pool[index];
+        if(graph->frame - pooled->last_frame > SGL_RENDER_POOL_IDLE_FRAMES)
+        {
+            sgl_internal_graph_framebuffers_release(graph, pooled->texture);
+            sgl_internal_texture_delete(&pooled->texture);
+            *pooled = graph->pool[--graph->pool_count];
+            continue;
+        }
+        graph->stats.pool_bytes += (uint64)pooled->desc.width*pooled->desc.height*sgl_internal_format_bytes(pooled->desc.format);
+        ++index;
+    }
+    graph->stats.pool_textures = graph->pool_count;
+}
+
+//@NOTE: false if the attachments don't make a complete framebuffer, *result is 0 for the backbuffer.
+internal bool32
+sgl_internal_graph_framebuffer(SGLRenderGraph* graph, sgl_graph_pass* pass, GLuint* result, int32* width, int32* height)
+{
+    GLuint attachments[SGL_RENDER_GRAPH_MAX_COLOR + 1] = {};
+    GLenum depth_format = 0;
+    int32 color_count = 0;
+    for(int32 write = 0; write < pass->write_count; ++write)
+    {
+        sgl_graph_resource* resource = &graph->resources[pass->writes[write]];
+        *width = resource->desc.width;
+        *height = resource->desc.height;
+        if(resource->flags & SGL_GRAPH_RESOURCE_BACKBUFFER)
+        {
+            //sgl_render_graph_write keeps anything else out of this pass.
+            *result = 0;
+            return true;
+        }
+        if(sgl_internal_format_is_depth(resource->desc.format))
+        {
+            attachments[SGL_RENDER_GRAPH_MAX_COLOR] = resource->texture;
+            depth_format = resource->desc.format;
+        }
+        else if(color_count < SGL_RENDER_GRAPH_MAX_COLOR)
+        {
+            attachments[color_count++] = resource->texture;
+        }
+    }
+
+    for(int32 index = 0; index < graph->framebuffer_count; ++index)
+    {
+        sgl_render_pool_framebuffer* framebuffer = &graph->framebuffers[index];
+        if(!memcmp(framebuffer->attachments, attachments, sizeof(attachments)))
+        {
+            framebuffer->last_frame = graph->frame;
+            *result = framebuffer->framebuffer;
+            return !framebuffer->incomplete;
+        }
+    }
+
+    if(graph->framebuffer_count == SGL_RENDER_GRAPH_MAX_POOL)
+    {
+        //Drop the stalest one.
+        int32 oldest = 0;
+        for(int32 index = 1; index < graph->framebuffer_count; ++index)
+        {
+            if(graph->framebuffers[index].last_frame < graph->framebuffers[oldest].last_frame)
+            {
+                oldest = index;
+            }
+        }
+        glDeleteFramebuffers(1, &graph->framebuffers[oldest].framebuffer);
+        graph->framebuffers[oldest] = graph->framebuffers[--graph->framebuffer_count];
+    }
+    sgl_render_pool_framebuffer* framebuffer = &graph->framebuffers[graph->framebuffer_count++];
+    memcpy(framebuffer->attachments, attachments, sizeof(attachments));
+    framebuffer->last_frame = graph->frame;
+    framebuffer->framebuffer = sgl_internal_framebuffer_create(attachments, color_count, attachments[SGL_RENDER_GRAPH_MAX_COLOR], depth_format);
+    framebuffer->incomplete = !framebuffer->framebuffer;
+    if(framebuffer->incomplete)
+    {
+        fprintf(stderr, "SGL render graph : pass [%s] has an incomplete framebuffer, skipping it\n", pass->name);
+    }
+    *result = framebuffer->framebuffer;
+    return !framebuffer->incomplete;
+}
+
+void
+sgl_render_graph_execute(SGLRenderGraph* graph)
+{
+    sgl_internal_graph_cull(graph);
+    sgl_internal_graph_allocate(graph);
+    graph->stats.passes_skipped = 0;
+
+    for(int32 index = 0; index < graph->pass_count; ++index)
+    {
+        sgl_graph_pass* pass = &graph->passes[index];
+        if(!pass->live)
+        {
+            continue;
+        }
+        int32 width = 0;
+        int32 height = 0;
+        GLuint framebuffer = 0;
+        if(!sgl_internal_graph_framebuffer(graph, pass, &framebuffer, &width, &height))
+        {
+            ++graph->stats.passes_skipped;
+            continue;
+        }
+        if(glPushDebugGroup && pass->name)
+        {
+            glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, index, -1, pass->name);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glViewport(0, 0, width, height);
+        if(pass->clear_mask)
+        {
+            glClearColor(pass->clear_color[0], pass->clear_color[1], pass->clear_color[2], pass->clear_color[3]);
+            glClearDepth(1.0);
+            glClear(pass->clear_mask);
+        }
+        if(pass->func)
+        {
+            pass->func(graph, pass->data);
+        }
+        if(glPopDebugGroup && pass->name)
+        {
+            glPopDebugGroup();
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+//[END Render Graph] ---------------------
+
+//
+//[Tiled Rendering] ---------------------
+
+internal void
+sgl_internal_tile_ppm_writer(void* user, int32 x, int32 y, int32 width, const uint8* rgba)
+{
+    SGLTiledRender* render = (SGLTiledRender*)user;
+    //RGBA -> RGB in place, the row buffer is ours.
+    uint8* rgb = (uint8*)rgba;
+    for(int32 pixel = 0; pixel < width; ++pixel)
+    {
+        rgb[pixel*3 + 0] = rgba[pixel*4 + 0];
+        rgb[pixel*3 + 1] = rgba[pixel*4 + 1];
+        rgb[pixel*3 + 2] = rgba[pixel*4 + 2];
+    }
+    LARGE_INTEGER offset;
+    offset.QuadPart = (LONGLONG)(render->file_header_size + ((uint64)y*render->width + x)*3);
+    DWORD written = 0;
+    if(!SetFilePointerEx(render->file, offset, 0, FILE_BEGIN) ||
+       !WriteFile(render->file, rgb, (DWORD)width*3, &written, 0) || written != (DWORD)width*3)
+    {
+        render->failed = true;
+    }
+}
+
+//@NOTE: Doesn't clear render, begin_file has already put the file in there.
+internal bool32
+sgl_internal_tiled_render_begin(SGLTiledRender* render, int32 width, int32 height, sgl_tile_writer_func* writer, void* user,
+                                int32 tile_size)
+{
+    GLint max_renderbuffer = 0;
+    GLint max_texture = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &max_renderbuffer);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture);
+    int32 limit = max_renderbuffer < max_texture ? max_renderbuffer : max_texture;
+    if(limit > 4096)
+    {
+        limit = 4096;
+    }
+    if(tile_size <= 0 || tile_size > limit)
+    {
+        tile_size = limit;
+    }
+    //A small image doesn't need a 4096 target (and 64MB pixel buffers).
+    int32 image_size = width > height ? width : height;
+    if(tile_size > image_size)
+    {
+        tile_size = image_size;
+    }
+    if(tile_size <= 0)
+    {
+        render->failed = true;
+        sgl_tiled_render_end(render);
+        return false;
+    }
+
+    render->width     = width;
+    render->height    = height;
+    render->tile_size = tile_size;
+    render->columns   = (width + tile_size - 1) / tile_size;
+    render->rows      = (height + tile_size - 1) / tile_size;
+    render->writer    = writer;
+    render->user      = user;
+    render->row       = (uint8*)sgl_internal_alloc(tile_size*4);
+    if(!render->row || !sgl_render_target_create(&render->target, tile_size, tile_size))
+    {
+        sgl_tiled_render_end(render);
+        return false;
+    }
+    for(int32 index = 0; index < SGL_TILE_PIPELINE_DEPTH; ++index)
+    {
+        glGenBuffers(1, &render->readbacks[index].buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, render->readbacks[index].buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)tile_size*tile_size*4, 0, GL_STREAM_READ);
+        SGL_GPU_TRACK(SGL_GPU_BUFFER, render->readbacks[index].buffer, (uint64)tile_size*tile_size*4, GL_RGBA8, "SGL Tile Readback");
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return true;
+}
+
+bool32
+sgl_tiled_render_begin(SGLTiledRender* render, int32 width, int32 height, sgl_tile_writer_func* writer, void* user,
+                       int32 tile_size)
+{
+    *render = {};
+    return sgl_internal_tiled_render_begin(render, width, height, writer, user, tile_size);
+}
+
+bool32
+sgl_tiled_render_begin_file(SGLTiledRender* render, int32 width, int32 height, const char* ppm_path, int32 tile_size)
+{
+    *render = {};
+    HANDLE file = CreateFileA(ppm_path, GENERIC_WRITE, 0, 0, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, 0);
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    char header[64];
+    int32 header_size = sprintf(header, "P6\n%d %d\n255\n", width, height);
+    DWORD written = 0;
+    render->file = file;
+    render->file_header_size = header_size;
+    if(!WriteFile(file, header, header_size, &written, 0) || written != (DWORD)header_size)
+    {
+        render->failed = true;
+        sgl_tiled_render_end(render);
+        return false;
+    }
+    return sgl_internal_tiled_render_begin(render, width, height, sgl_internal_tile_ppm_writer, render, tile_size);
+}
+
+bool32
+sgl_tiled_render_end(SGLTiledRender* render)
+{
+    bool32 succeeded = !render->failed && !render->rendering && !render->pending_count &&
+                       render->next_tile == render->columns*render->rows;
+    for(int32 index = 0; index < SGL_TILE_PIPELINE_DEPTH; ++index)
+    {
+        sgl_tile_readback* readback = &render->readbacks[index];
+        if(readback->fence)
+        {
+            glDeleteSync(readback->fence);
+        }
+        if(readback->buffer)
+        {
+            sgl_internal_buffer_delete(&readback->buffer);
+        }
+    }
+    if(render->target.framebuffer)
+    {
+        sgl_render_target_bind(0);
+        sgl_render_target_free(&render->target);
+    }
+    if(render->file && render->file != INVALID_HANDLE_VALUE && !CloseHandle(render->file))
+    {
+        succeeded = false;
+    }
+    sgl_internal_free(render->row);
+    *render = {};
+    render->failed = !succeeded;
+    return succeeded;
+}
+
+//Waits for the oldest read back, hands its rows to the writer and frees its slot.
+internal void
+sgl_internal_tile_complete(SGLTiledRender* render)
+{
+    sgl_tile_readback* readback = &render->readbacks[render->first_pending];
+    GLenum status = glClientWaitSync(readback->fence, 0, 0);
+    if(status == GL_TIMEOUT_EXPIRED)
+    {
+        ++render->stalls;
+        do
+        {
+            status = glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while(status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(readback->fence);
+    readback->fence = 0;
+
+    SGLTile* tile = &readback->tile;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+    const uint8* pixels = (const uint8*)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)tile->width*tile->height*4,
+                                                          GL_MAP_READ_BIT);
+    if(pixels)
+    {
+        //GL rows go bottom up.
+        for(int32 row = 0; row < tile->height; ++row)
+        {
+            memcpy(render->row, pixels + (size_t)(tile->height - 1 - row)*tile->width*4, tile->width*4);
+            render->writer(render->user, tile->x, tile->y + row, tile->width, render->row);
+        }
+        if(!glUnmapBuffer(GL_PIXEL_PACK_BUFFER))
+        {
+            //The store got corrupted while mapped, what we handed out may be garbage.
+            render->failed = true;
+        }
+    }
+    else
+    {
+        render->failed = true;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    render->first_pending = (render->first_pending + 1) % SGL_TILE_PIPELINE_DEPTH;
+    --render->pending_count;
+}
+
+bool32
+sgl_tiled_render_next(SGLTiledRender* render, SGLTile* tile)
+{
+    if(render->rendering)
+    {
+        //Kick off the read back of the tile that was just drawn, it lands in the pixel buffer asynchronously.
+        if(render->pending_count == SGL_TILE_PIPELINE_DEPTH)
+        {
+            sgl_internal_tile_complete(render);
+        }
+        uint32 slot = (render->first_pending + render->pending_count) % SGL_TILE_PIPELINE_DEPTH;
+        sgl_tile_readback* readback = &render->readbacks[slot];
+        readback->tile = render->current;
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, render->target.framebuffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback->buffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, render->current.width, render->current.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        ++render->pending_count;
+        render->rendering = false;
+    }
+
+    if(render->failed || render->next_tile == render->columns*render->rows)
+    {
+        while(render->pending_count && !render->failed)
+        {
+            sgl_internal_tile_complete(render);
+        }
+        sgl_tiled_render_end(render);
+        return false;
+    }
+
+    SGLTile* next = &render->current;
+    next->index  = render->next_tile++;
+    next->x      = (next->index % render->columns)*render->tile_size;
+    next->y      = (next->index / render->columns)*render->tile_size;
+    next->width  = render->width - next->x < render->tile_size ? render->width - next->x : render->tile_size;
+    next->height = render->height - next->y < render->tile_size ? render->height - next->y : render->tile_size;
+    //Image y goes down, NDC y goes up.
+    next->ndc[0] = 2.0f*next->x/render->width - 1.0f;
+    next->ndc[1] = 1.0f - 2.0f*(next->y + next->height)/render->height;
+    next->ndc[2] = 2.0f*(next->x + next->width)/render->width - 1.0f;
+    next->ndc[3] = 1.0f - 2.0f*next->y/render->height;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, render->target.framebuffer);
+    glViewport(0, 0, next->width, next->height);
+    render->rendering = true;
+    *tile = *next;
+    return true;
+}
+
+void
+sgl_tile_projection(SGLTile* tile, const float* projection, float* tile_projection)
+{
+    //Scale and offset the tile's NDC rectangle to [-1, 1] after the projection : clip.x' = sx*clip.x + ox*clip.w
+    float scale_x  = 2.0f/(tile->ndc[2] - tile->ndc[0]);
+    float scale_y  = 2.0f/(tile->ndc[3] - tile->ndc[1]);
+    float offset_x = -(tile->ndc[2] + tile->ndc[0])/(tile->ndc[2] - tile->ndc[0]);
+    float offset_y = -(tile->ndc[3] + tile->ndc[1])/(tile->ndc[3] - tile->ndc[1]);
+    for(int32 column = 0; column < 4; ++column)
+    {
+        const float* source = projection + column*4;
+        float* destination = tile_projection + column*4;
+        destination[0] = scale_x*source[0] + offset_x*source[3];
+        destination[1] = scale_y*source[1] + offset_y*source[3];
+        destination[2] = source[2];
+        destination[3] = source[3];
+    }
+}
+
+//[END Tiled Rendering] ---------------------
+
+//
+//[Compute] ---------------------
+
+//@NOTE: A barrier makes every write issued before it visible to the uses in its bits. So instead of
+//tracking buffers we number dispatches : a buffer needs a barrier for a use if it was written after the
+//last barrier that covered that use.
+struct sgl_compute_state {
+    uint64 sequence;                        //Dispatches so far
+    uint64 covered[SGL_BUFFER_USE_COUNT];   //Sequence the last barrier for each use covered
+};
+global_variable sgl_compute_state sgl_compute;
+
+global_variable const GLbitfield sgl_compute_barrier_bits[SGL_BUFFER_USE_COUNT] =
+{
+    GL_SHADER_STORAGE_BARRIER_BIT,
+    GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT,
+    GL_ELEMENT_ARRAY_BARRIER_BIT,
+    GL_COMMAND_BARRIER_BIT,
+    GL_UNIFORM_BARRIER_BIT,
+    GL_BUFFER_UPDATE_BARRIER_BIT,
+};
+
+//Adds the barrier bits the write needs before the uses to *bits.
+internal void
+sgl_internal_compute_barrier_gather(uint64 write_sequence, uint32 uses, GLbitfield* bits)
+{
+    for(uint32 use = 0; use < SGL_BUFFER_USE_COUNT; ++use)
+    {
+        if((uses & (1 << use)) && write_sequence > sgl_compute.covered[use])
+        {
+            *bits |= sgl_compute_barrier_bits[use];
+        }
+    }
+}
+
+internal void
+sgl_internal_compute_barrier_issue(GLbitfield bits)
+{
+    if(!bits)
+    {
+        return;
+    }
+    glMemoryBarrier(bits);
+    for(uint32 use = 0; use < SGL_BUFFER_USE_COUNT; ++use)
+    {
+        if(bits & sgl_compute_barrier_bits[use])
+        {
+            sgl_compute.covered[use] = sgl_compute.sequence;
+        }
+    }
+}
+
+bool32
+sgl_compute_supported()
+{
+    return glDispatchCompute && glDispatchComputeIndirect && glMemoryBarrier;
+}
+
+bool32
+sgl_compute_program_create(SGLComputeProgram* program, const char* source, char* debug_name)
+{
+    *program = {};
+    GLuint shader = sgl_internal_shader_create(GL_COMPUTE_SHADER, source);
+    program->program = sgl_internal_program_create(&shader, 1, debug_name ? debug_name : (char*)"SGL Compute");
+    glDeleteShader(shader);
+
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program->program, GL_LINK_STATUS, &linked);
+    if(linked != GL_TRUE)
+    {
+        sgl_compute_program_free(program);
+        return false;
+    }
+    glGetProgramiv(program->program, GL_COMPUTE_WORK_GROUP_SIZE, program->local_size);
+    return true;
+}
+
+void
+sgl_compute_program_free(SGLComputeProgram* program)
+{
+    sgl_internal_program_delete(&program->program);
+    *program = {};
+}
+
+uint32
+sgl_compute_groups(uint32 item_count, int32 local_size)
+{
+    //A program that failed to build has no local size.
+    if(local_size <= 0)
+    {
+        return 0;
+    }
+    return (item_count + local_size - 1) / local_size;
+}
+
+bool32
+sgl_storage_buffer_create(SGLStorageBuffer* buffer, uint64 size, const void* data, GLenum usage)
+{
+    *buffer = {};
+    buffer->size = size;
+    glGenBuffers(1, &buffer->buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)size, data, usage);
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, buffer->buffer, size, 0, "SGL Storage Buffer");
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    return buffer->buffer != 0;
+}
+
+void
+sgl_storage_buffer_free(SGLStorageBuffer* buffer)
+{
+    sgl_internal_buffer_delete(&buffer->buffer);
+    *buffer = {};
+}
+
+void
+sgl_storage_buffer_upload(SGLStorageBuffer* buffer, uint64 offset, const void* data, uint64 size)
+{
+    //Shader writes still in flight must land before ours.
+    GLbitfield bits = 0;
+    sgl_internal_compute_barrier_gather(buffer->write_sequence, SGL_BUFFER_USE_UPDATE, &bits);
+    sgl_internal_compute_barrier_issue(bits);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer->buffer);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, (GLintptr)offset, (GLsizeiptr)size, data);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void
+sgl_storage_buffer_barrier(SGLStorageBuffer* buffer, uint32 uses)
+{
+    GLbitfield bits = 0;
+    sgl_internal_compute_barrier_gather(buffer->write_sequence, uses, &bits);
+    sgl_internal_compute_barrier_issue(bits);
+}
+
+//Barrier for everything the bindings touch, bind them, and return the new dispatch's sequence.
+internal uint64
+sgl_internal_compute_prepare(SGLComputeProgram* program, SGLComputeBinding* bindings, int32 binding_count,
+                             SGLStorageBuffer* arguments)
+{
+    GLbitfield bits = 0;
+    for(int32 index = 0; index < binding_count; ++index)
+    {
+        sgl_internal_compute_barrier_gather(bindings[index].buffer->write_sequence, SGL_BUFFER_USE_STORAGE, &bits);
+    }
+    if(arguments)
+    {
+        sgl_internal_compute_barrier_gather(arguments->write_sequence, SGL_BUFFER_USE_INDIRECT, &bits);
+    }
+    sgl_internal_compute_barrier_issue(bits);
+
+    glUseProgram(program->program);
+    for(int32 index = 0; index < binding_count; ++index)
+    {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindings[index].binding, bindings[index].buffer->buffer);
+    }
+    return ++sgl_compute.sequence;
+}
+
+internal void
+sgl_internal_compute_finish(SGLComputeBinding* bindings, int32 binding_count, uint64 sequence)
+{
+    for(int32 index = 0; index < binding_count; ++index)
+    {
+        if(bindings[index].writes)
+        {
+            bindings[index].buffer->write_sequence = sequence;
+        }
+    }
+    glUseProgram(0);
+}
 
-//[OpenGL Function Declarations] --------------------------------------------------------------------------------
+void
+sgl_compute_dispatch(SGLComputeProgram* program, SGLComputeBinding* bindings, int32 binding_count,
+                     uint32 groups_x, uint32 groups_y, uint32 groups_z)
+{
+    uint64 sequence = sgl_internal_compute_prepare(program, bindings, binding_count, 0);
+    glDispatchCompute(groups_x, groups_y, groups_z);
+    sgl_internal_compute_finish(bindings, binding_count, sequence);
+}
 
-	DECLARE_GL_FUNC_PTR(void, glActiveTexture, (GLenum))
-	DECLARE_GL_FUNC_PTR(void, glMultiDrawElements, (GLenum, const GLsizei *, GLenum, const void *const *, GLsizei))
-	DECLARE_GL_FUNC_PTR(void, glEnableVertexAttribArray, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glDisableVertexAttribArray, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glVertexAttribPointer, (GLuint, GLint, GLenum, GLboolean, GLsizei, const void *))
-	DECLARE_GL_FUNC_PTR(void, glGenBuffers, (GLsizei, GLuint *))
-	DECLARE_GL_FUNC_PTR(void, glDeleteBuffers, (GLsizei, const GLuint *))
-	DECLARE_GL_FUNC_PTR(void, glBindBuffer, (GLenum, GLuint))
-	DECLARE_GL_FUNC_PTR(void, glBufferData, (GLenum, GLsizeiptr, const void *, GLenum))
-	DECLARE_GL_FUNC_PTR(void *, glMapBuffer, (GLenum, GLenum))
-	DECLARE_GL_FUNC_PTR(GLboolean, glUnmapBuffer, (GLenum))
-	DECLARE_GL_FUNC_PTR(GLuint, glCreateShader, (GLenum))
-	DECLARE_GL_FUNC_PTR(void, glDeleteShader, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glShaderSource, (GLuint, GLsizei, const GLchar **, const GLint *))
-	DECLARE_GL_FUNC_PTR(void, glCompileShader, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glAttachShader, (GLuint, GLuint))
-	DECLARE_GL_FUNC_PTR(GLuint, glCreateProgram, (void))
-	DECLARE_GL_FUNC_PTR(void, glDeleteProgram, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glLinkProgram, (GLuint))
-	DECLARE_GL_FUNC_PTR(void, glUseProgram, (GLuint))
-	DECLARE_GL_FUNC_PTR(GLint, glGetUniformLocation, (GLuint, const GLchar *))
-	DECLARE_GL_FUNC_PTR(void, glUniform1i, (GLint, GLint))
-	DECLARE_GL_FUNC_PTR(void, glUniform4f, (GLint, GLfloat, GLfloat, GLfloat, GLfloat))
-	DECLARE_GL_FUNC_PTR(void, glUniform4fv, (GLint, GLsizei, const GLfloat *))
-	DECLARE_GL_FUNC_PTR(void, glGenQueries, (GLsizei, GLuint *))
-	DECLARE_GL_FUNC_PTR(void, glDeleteQueries, (GLsizei, const GLuint *))
-	DECLARE_GL_FUNC_PTR(void, glBeginQuery, (GLenum, GLuint))
-	DECLARE_GL_FUNC_PTR(void, glEndQuery, (GLenum))
-    DECLARE_GL_FUNC_PTR(void, glGenVertexArrays, (GLsizei, GLuint *))
-    DECLARE_GL_FUNC_PTR(void, glDeleteVertexArrays, (GLsizei, const GLuint *))
-    DECLARE_GL_FUNC_PTR(void, glBindVertexArray, (GLuint))
-    DECLARE_GL_FUNC_PTR(void, glGetShaderiv, (GLuint, GLenum, GLint *))
-    DECLARE_GL_FUNC_PTR(void, glGetShaderInfoLog, (GLuint, GLsizei, GLsizei, GLchar *))
-    DECLARE_GL_FUNC_PTR(void, glGetProgramiv, (GLuint, GLenum, GLint *)) 
-    DECLARE_GL_FUNC_PTR(void, glGetProgramInfoLog, (GLuint, GLsizei, GLsizei *, GLchar *))
-    DECLARE_GL_FUNC_PTR(void, glDetachShader, (GLuint, GLuint))
-    
-    //[DECLARE NEW GL FUNCTION]
-    //Declare any new functions here...
+void
+sgl_compute_dispatch_indirect(SGLComputeProgram* program, SGLComputeBinding* bindings, int32 binding_count,
+                              SGLStorageBuffer* arguments, uint64 offset)
+{
+    uint64 sequence = sgl_internal_compute_prepare(program, bindings, binding_count, arguments);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, arguments->buffer);
+    glDispatchComputeIndirect((GLintptr)offset);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+    sgl_internal_compute_finish(bindings, binding_count, sequence);
+}
 
-//[END OpenGL Function Delarations] -------------------------------------------------------------------------------------------------------
+void
+sgl_compute_readback_begin(SGLComputeReadback* readback, SGLStorageBuffer* source, uint64 offset, uint64 size)
+{
+    if(readback->mapped)
+    {
+        sgl_compute_readback_unmap(readback);
+    }
+    if(readback->fence)
+    {
+        glDeleteSync(readback->fence);
+        readback->fence = 0;
+    }
+    if(!readback->buffer)
+    {
+        glGenBuffers(1, &readback->buffer);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+    if(size > readback->capacity)
+    {
+        glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)size, 0, GL_STREAM_READ);
+        SGL_GPU_TRACK(SGL_GPU_BUFFER, readback->buffer, size, 0, "SGL Compute Readback");
+        readback->capacity = size;
+    }
+    readback->size = size;
+
+    sgl_storage_buffer_barrier(source, SGL_BUFFER_USE_UPDATE);
+    glBindBuffer(GL_COPY_READ_BUFFER, source->buffer);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)offset, 0, (GLsizeiptr)size);
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    readback->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    //Make sure the copy actually gets submitted, or polling ready() could spin forever.
+    glFlush();
+}
 
-void sgl_load_gl_functions()
+bool32
+sgl_compute_readback_ready(SGLComputeReadback* readback)
 {
-    GET_GL_FUNC_SAFE(glActiveTexture)
-	GET_GL_FUNC_SAFE(glMultiDrawElements)
-	GET_GL_FUNC_SAFE(glEnableVertexAttribArray)
-	GET_GL_FUNC_SAFE(glDisableVertexAttribArray)
-	GET_GL_FUNC_SAFE(glVertexAttribPointer)
-	GET_GL_FUNC_SAFE(glGenBuffers)
-	GET_GL_FUNC_SAFE(glDeleteBuffers)
-	GET_GL_FUNC_SAFE(glBindBuffer)
-	GET_GL_FUNC_SAFE(glBufferData)
-	GET_GL_FUNC_SAFE(glMapBuffer)
-	GET_GL_FUNC_SAFE(glUnmapBuffer)
-	GET_GL_FUNC_SAFE(glCreateShader)
-	GET_GL_FUNC_SAFE(glDeleteShader)
-	GET_GL_FUNC_SAFE(glShaderSource)
-	GET_GL_FUNC_SAFE(glCompileShader)
-	GET_GL_FUNC_SAFE(glAttachShader)
-	GET_GL_FUNC_SAFE(glCreateProgram)
-	GET_GL_FUNC_SAFE(glDeleteProgram)
-	GET_GL_FUNC_SAFE(glLinkProgram)
-	GET_GL_FUNC_SAFE(glUseProgram)
-	GET_GL_FUNC_SAFE(glGetUniformLocation)
-	GET_GL_FUNC_SAFE(glUniform1i)
-	GET_GL_FUNC_SAFE(glUniform4f)
-	GET_GL_FUNC_SAFE(glUniform4fv)
-	GET_GL_FUNC_SAFE(glGenQueries)
-	GET_GL_FUNC_SAFE(glDeleteQueries)
-	GET_GL_FUNC_SAFE(glBeginQuery)
-	GET_GL_FUNC_SAFE(glEndQuery)
-    GET_GL_FUNC_SAFE(glGenVertexArrays)
-    GET_GL_FUNC_SAFE(glDeleteVertexArrays)
-    GET_GL_FUNC_SAFE(glBindVertexArray)
-    GET_GL_FUNC_SAFE(glGetShaderiv)
-    GET_GL_FUNC_SAFE(glGetShaderInfoLog)
-    GET_GL_FUNC_SAFE(glGetProgramiv)
-    GET_GL_FUNC_SAFE(glGetProgramInfoLog)
-    GET_GL_FUNC_SAFE(glDetachShader)
+    if(!readback->fence)
+    {
+        return readback->mapped != 0;
+    }
+    GLenum status = glClientWaitSync(readback->fence, 0, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
 
-    //[LOAD NEW FUNCTION]
-    // Load any other functions you might need here.
+const void*
+sgl_compute_readback_map(SGLComputeReadback* readback)
+{
+    if(readback->mapped)
+    {
+        return readback->mapped;
+    }
+    if(!readback->fence)
+    {
+        return 0;
+    }
+    GLenum status;
+    do
+    {
+        status = glClientWaitSync(readback->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } while(status == GL_TIMEOUT_EXPIRED);
+    glDeleteSync(readback->fence);
+    readback->fence = 0;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+    readback->mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, (GLsizeiptr)readback->size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    return readback->mapped;
+}
+
+void
+sgl_compute_readback_unmap(SGLComputeReadback* readback)
+{
+    if(readback->mapped)
+    {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, readback->buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        readback->mapped = 0;
+    }
+}
+
+void
+sgl_compute_readback_free(SGLComputeReadback* readback)
+{
+    sgl_compute_readback_unmap(readback);
+    if(readback->fence)
+    {
+        glDeleteSync(readback->fence);
+    }
+    if(readback->buffer)
+    {
+        sgl_internal_buffer_delete(&readback->buffer);
+    }
+    *readback = {};
 }
-//
-//[END OpenGL Functions] ---------------------
+
+//[END Compute] ---------------------
 
 //
 //[Win32] ---------------------
@@ -385,6 +6708,7 @@ void sgl_load_gl_functions()
 //[INTERNAL] - Declaring Win32 specific OpenGL function pointers.
 DECLARE_GL_FUNC_PTR(BOOL ,wglChoosePixelFormatARB, (HDC , const int *, const FLOAT *, UINT , int *, UINT *))
 DECLARE_GL_FUNC_PTR(HGLRC ,wglCreateContextAttribsARB, (HDC , HGLRC , const int *))
+DECLARE_GL_FUNC_PTR(BOOL ,wglGetPixelFormatAttribivARB, (HDC , int , int , UINT , const int *, int *))
 
 
 internal void 
@@ -440,29 +6764,200 @@ sgl_win32_window_create(SGLWindow* window,HINSTANCE instance,win32_window_callba
     }
 }
 
+internal PIXELFORMATDESCRIPTOR
+sgl_win32_legacy_pixel_format(SGLFramebufferConfig* config)
+{
+    PIXELFORMATDESCRIPTOR pixel_format = {};
+    pixel_format.nSize = sizeof(pixel_format);
+    pixel_format.nVersion = 1;   
+    pixel_format.dwFlags = PFD_DRAW_TO_WINDOW|PFD_SUPPORT_OPENGL;
+    if(config->double_buffer) pixel_format.dwFlags |= PFD_DOUBLEBUFFER;
+    if(!config->depth_bits)   pixel_format.dwFlags |= PFD_DEPTH_DONTCARE;
+    pixel_format.iPixelType   = PFD_TYPE_RGBA;
+    pixel_format.cColorBits   = (BYTE)config->color_bits;
+    pixel_format.cAlphaBits   = (BYTE)config->alpha_bits;
+    pixel_format.cDepthBits   = (BYTE)config->depth_bits;
+    pixel_format.cStencilBits = (BYTE)config->stencil_bits;
+    pixel_format.iLayerType   = PFD_MAIN_PLANE;
+    return pixel_format;
+}
+
+//@NOTE: wglChoosePixelFormatARB can only be loaded with a context current and a window's pixel format
+//can only be set once, so we load the WGL extensions through a throwaway window and context.
+internal bool32
+sgl_win32_load_wgl_extensions()
+{
+    local_persist bool32 loaded = false;
+    if(loaded)
+    {
+        return (wglChoosePixelFormatARB && wglGetPixelFormatAttribivARB);
+    }
+    loaded = true;
+
+    HINSTANCE instance = GetModuleHandle(0);
+    WNDCLASSA window_class = {};
+    window_class.style = CS_OWNDC;
+    window_class.lpfnWndProc = DefWindowProcA;
+    window_class.hInstance = instance;
+    window_class.lpszClassName = "SGL Dummy Window";
+    RegisterClassA(&window_class);
+
+    HWND dummy_window = CreateWindowExA(0, window_class.lpszClassName, window_class.lpszClassName, 0,
+                                        CW_USEDEFAULT, CW_USEDEFAULT, CW_USEDEFAULT, CW_USEDEFAULT,
+                                        0, 0, instance, 0);
+    if(dummy_window)
+    {
+        HDC dummy_dc = GetDC(dummy_window);
+        SGLFramebufferConfig dummy_config = sgl_framebuffer_config_default();
+        PIXELFORMATDESCRIPTOR dummy_pixel_format = sgl_win32_legacy_pixel_format(&dummy_config);
+        int32 dummy_format_index = ChoosePixelFormat(dummy_dc, &dummy_pixel_format);
+        DescribePixelFormat(dummy_dc, dummy_format_index, sizeof(dummy_pixel_format), &dummy_pixel_format);
+        SetPixelFormat(dummy_dc, dummy_format_index, &dummy_pixel_format);
+
+        HGLRC dummy_context = wglCreateContext(dummy_dc);
+        if(wglMakeCurrent(dummy_dc, dummy_context))
+        {
+            GET_GL_FUNC(wglChoosePixelFormatARB)
+            GET_GL_FUNC(wglGetPixelFormatAttribivARB)
+            wglMakeCurrent(0, 0);
+        }
+        wglDeleteContext(dummy_context);
+        ReleaseDC(dummy_window, dummy_dc);
+        DestroyWindow(dummy_window);
+    }
+    UnregisterClassA(window_class.lpszClassName, instance);
+
+    return (wglChoosePixelFormatARB && wglGetPixelFormatAttribivARB);
+}
+
+internal void
+sgl_win32_describe_pixel_format(HDC device_context, int32 format_index, SGLFramebufferConfig* result)
+{
+    *result = {};
+    result->initialized = true;
+    if(wglGetPixelFormatAttribivARB)
+    {
+        const int attribs[] = 
+        {
+            WGL_COLOR_BITS_ARB, WGL_ALPHA_BITS_ARB, WGL_DEPTH_BITS_ARB, WGL_STENCIL_BITS_ARB, WGL_DOUBLE_BUFFER_ARB
+        };
+        int values[5] = {};
+        if(wglGetPixelFormatAttribivARB(device_context, format_index, 0, 5, attribs, values))
+        {
+            result->color_bits    = values[0];
+            result->alpha_bits    = values[1];
+            result->depth_bits    = values[2];
+            result->stencil_bits  = values[3];
+            result->double_buffer = values[4];
+
+            //@NOTE: These are queried on their own, drivers without ARB_multisample or
+            //ARB_framebuffer_sRGB fail the whole query if the attribute is unknown.
+            int attrib = WGL_SAMPLE_BUFFERS_ARB;
+            int value = 0;
+            if(wglGetPixelFormatAttribivARB(device_context, format_index, 0, 1, &attrib, &value) && value)
+            {
+                attrib = WGL_SAMPLES_ARB;
+                wglGetPixelFormatAttribivARB(device_context, format_index, 0, 1, &attrib, &result->samples);
+            }
+            attrib = WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB;
+            value = 0;
+            wglGetPixelFormatAttribivARB(device_context, format_index, 0, 1, &attrib, &value);
+            result->srgb = value;
+            return;
+        }
+    }
+
+    PIXELFORMATDESCRIPTOR pixel_format;
+    DescribePixelFormat(device_context, format_index, sizeof(pixel_format), &pixel_format);
+    result->color_bits    = pixel_format.cColorBits;
+    result->alpha_bits    = pixel_format.cAlphaBits;
+    result->depth_bits    = pixel_format.cDepthBits;
+    result->stencil_bits  = pixel_format.cStencilBits;
+    result->double_buffer = (pixel_format.dwFlags & PFD_DOUBLEBUFFER) != 0;
+}
+
+//Returns 0 if no format matched.
+internal int32
+sgl_win32_choose_pixel_format_arb(HDC device_context, SGLFramebufferConfig* config)
+{
+    int attribs[32];
+    int32 count = 0;
+    attribs[count++] = WGL_DRAW_TO_WINDOW_ARB; attribs[count++] = GL_TRUE;
+    attribs[count++] = WGL_SUPPORT_OPENGL_ARB; attribs[count++] = GL_TRUE;
+    attribs[count++] = WGL_ACCELERATION_ARB;   attribs[count++] = WGL_FULL_ACCELERATION_ARB;
+    attribs[count++] = WGL_PIXEL_TYPE_ARB;     attribs[count++] = WGL_TYPE_RGBA_ARB;
+    attribs[count++] = WGL_DOUBLE_BUFFER_ARB;  attribs[count++] = config->double_buffer ? GL_TRUE : GL_FALSE;
+    attribs[count++] = WGL_COLOR_BITS_ARB;     attribs[count++] = config->color_bits;
+    attribs[count++] = WGL_ALPHA_BITS_ARB;     attribs[count++] = config->alpha_bits;
+    attribs[count++] = WGL_DEPTH_BITS_ARB;     attribs[count++] = config->depth_bits;
+    attribs[count++] = WGL_STENCIL_BITS_ARB;   attribs[count++] = config->stencil_bits;
+    if(config->samples > 0)
+    {
+        attribs[count++] = WGL_SAMPLE_BUFFERS_ARB; attribs[count++] = 1;
+        attribs[count++] = WGL_SAMPLES_ARB;        attribs[count++] = config->samples;
+    }
+    if(config->srgb)
+    {
+        attribs[count++] = WGL_FRAMEBUFFER_SRGB_CAPABLE_ARB; attribs[count++] = GL_TRUE;
+    }
+    attribs[count++] = 0; //End
+    SGL_Assert(count <= 32);
+
+    //@NOTE: The bits we pass in are minimums and drivers sort bigger formats first, so asking for
+    //no depth usually hands back a 24 bit depth buffer. We ask for a bunch of candidates and pick the
+    //one closest to the request ourselves.
+    const UINT max_formats = 64;
+    int formats[max_formats];
+    UINT format_count = 0;
+    if(!wglChoosePixelFormatARB(device_context, attribs, 0, max_formats, formats, &format_count) || !format_count)
+    {
+        return 0;
+    }
+
+    int32 best_format = formats[0];
+    int32 best_distance = 0x7FFFFFFF;
+    for(UINT index = 0; index < format_count; ++index)
+    {
+        SGLFramebufferConfig candidate;
+        sgl_win32_describe_pixel_format(device_context, formats[index], &candidate);
+        int32 distance = sgl_internal_framebuffer_config_distance(config, &candidate);
+        if(distance < best_distance)
+        {
+            best_distance = distance;
+            best_format = formats[index];
+        }
+    }
+    return best_format;
+}
+
 internal bool32
 sgl_win32_window_ogl_setup(SGLWindow* window, int32 major_version, int32 minor_version)
 {
     window->device_context = GetDC(window->handle);
 
-     //Setup Pixel Format
-    PIXELFORMATDESCRIPTOR desired_pixel_format = {};
-    desired_pixel_format.nSize = sizeof(desired_pixel_format);
-    desired_pixel_format.nVersion = 1;   
-    desired_pixel_format.dwFlags = PFD_DRAW_TO_WINDOW|PFD_SUPPORT_OPENGL|PFD_DOUBLEBUFFER;
-    desired_pixel_format.iPixelType = PFD_TYPE_RGBA;
-    desired_pixel_format.cColorBits = 32; //@TODO: Allow to be specified by user
-    desired_pixel_format.cDepthBits = 8; //@TODO: Allow to be specified by user
-    desired_pixel_format.cStencilBits = 8;//@TODO: Allow to be specified by user
-    desired_pixel_format.cAlphaBits   = 8;//@TODO: Allow to be specified by user
-    desired_pixel_format.iLayerType = PFD_MAIN_PLANE;
+    //Setup Pixel Format
+    if(!window->framebuffer.initialized)
+    {
+        window->framebuffer = sgl_framebuffer_config_default();
+    }
 
-    int32 suggested_format_index = ChoosePixelFormat(window->device_context, &desired_pixel_format);
+    int32 format_index = 0;
+    if(sgl_win32_load_wgl_extensions())
+    {
+        format_index = sgl_win32_choose_pixel_format_arb(window->device_context, &window->framebuffer);
+    }
+    if(!format_index)
+    {
+        //@NOTE: No WGL_ARB_pixel_format (or nothing matched), MSAA and sRGB can't be requested this way.
+        PIXELFORMATDESCRIPTOR desired_pixel_format = sgl_win32_legacy_pixel_format(&window->framebuffer);
+        format_index = ChoosePixelFormat(window->device_context, &desired_pixel_format);
+    }
 
     PIXELFORMATDESCRIPTOR suggested_pixel_format;
-    DescribePixelFormat(window->device_context, suggested_format_index, 
+    DescribePixelFormat(window->device_context, format_index, 
                         sizeof(suggested_pixel_format), &suggested_pixel_format);
-    SetPixelFormat(window->device_context, suggested_format_index, &suggested_pixel_format);
+    SetPixelFormat(window->device_context, format_index, &suggested_pixel_format);
+    sgl_win32_describe_pixel_format(window->device_context, format_index, &window->framebuffer_chosen);
     
     window->rendering_context = wglCreateContext(window->device_context);
     if(wglMakeCurrent(window->device_context, window->rendering_context))
@@ -479,6 +6974,7 @@ sgl_win32_window_ogl_setup(SGLWindow* window, int32 major_version, int32 minor_v
                 //WGL_CONTEXT_MAJOR_VERSION_ARB, 3,
                 //WGL_CONTEXT_MINOR_VERSION_ARB, 3,
                 WGL_CONTEXT_PROFILE_MASK_ARB, WGL_CONTEXT_CORE_PROFILE_BIT_ARB,
+                WGL_CONTEXT_FLAGS_ARB, window->debug_context ? WGL_CONTEXT_DEBUG_BIT_ARB : 0,
                 0, 0 //End
             };
             
@@ -499,6 +6995,16 @@ sgl_win32_window_ogl_setup(SGLWindow* window, int32 major_version, int32 minor_v
             //@TODO: Could not create modern gl context, old version of OGL
         }
 
+        if(window->framebuffer_chosen.samples > 0)
+        {
+            glEnable(GL_MULTISAMPLE);
+        }
+        //Plenty of drivers report every format as sRGB capable, only turn it on when it was asked for.
+        if(window->framebuffer.srgb && window->framebuffer_chosen.srgb)
+        {
+            glEnable(GL_FRAMEBUFFER_SRGB);
+        }
+
         //@TODO: Get OpenGL context info
         char* vendor     = (char *)glGetString(GL_VENDOR);
         char* renderer   = (char *)glGetString(GL_RENDERER);
@@ -512,6 +7018,18 @@ sgl_win32_window_ogl_setup(SGLWindow* window, int32 major_version, int32 minor_v
 
     sgl_load_gl_functions();
 
+    if(window->debug_context)
+    {
+        //Asking isn't getting, without the flag most drivers only send a fraction of the messages.
+        GLint context_flags = 0;
+        glGetIntegerv(GL_CONTEXT_FLAGS, &context_flags);
+        if(!(context_flags & GL_CONTEXT_FLAG_DEBUG_BIT))
+        {
+            fprintf(stderr, "SGL debug context requested but not granted, debug output will be sparse\n");
+        }
+        sgl_debug_output_setup();
+    }
+
     ReleaseDC(window->handle, window->device_context);
 
     return true;
@@ -558,6 +7076,28 @@ sgl_window(SGLWindow* window,HINSTANCE instance,win32_window_callback* window_ca
     sgl_win32_window_ogl_setup(window);
 }
 
+void
+sgl_window_destroy(SGLWindow* window)
+{
+    //Still current here, so anything reported can still be inspected in a GL debugger.
+    sgl_gpu_memory_report_leaks();
+    //The names die with the context, a later context would hand them out again.
+    sgl_gpu_memory_reset();
+    if(window->rendering_context)
+    {
+        wglMakeCurrent(0, 0);
+        wglDeleteContext(window->rendering_context);
+        window->rendering_context = 0;
+    }
+    if(window->handle)
+    {
+        DestroyWindow(window->handle);
+        window->handle = 0;
+    }
+    window->initialized = false;
+    window->running = false;
+}
+
 #endif //_WIN32
 
 
@@ -677,6 +7217,8 @@ WinMain(HINSTANCE Instance,
         sgl_win32_process_msgs();
         sgl_default_render(&default_main_window);
     }   
+    sgl_free_default_state();
+    sgl_window_destroy(&default_main_window);
     return 0;
 }
 
@@ -697,7 +7239,6 @@ GLfloat triangle_vertex_positions[] = {
 };
 
 struct sgl_default_renderer{
-    GLuint index_buffer;
     GLuint vertex_buffer;
     GLuint program_default; 
 };
@@ -726,71 +7267,6 @@ char* sgl_default_frag_shader[] =
  "}                               \n"
 };
 
-GLuint
-sgl_internal_shader_create(GLenum shader_type,const char* shader_file)
-{
-    GLuint shader = glCreateShader(shader_type);
-    glShaderSource(shader, 1,&shader_file, NULL);
-    glCompileShader(shader);
-    
-    GLint status;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
-    if (status == GL_FALSE)
-    {
-        GLint info_log_length;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &info_log_length);
-
-        //TODO(filipe): Get rid of this new...
-        GLchar *info_log = new GLchar[info_log_length + 1];
-        glGetShaderInfoLog(shader, info_log_length, NULL, info_log);
-
-        const char *string_shader_type = NULL;
-        switch(shader_type)
-        {
-            case GL_VERTEX_SHADER:   string_shader_type = "vertex"; break;
-            case GL_GEOMETRY_SHADER: string_shader_type = "geometry"; break;
-            case GL_FRAGMENT_SHADER: string_shader_type = "fragment"; break;
-        }
-        fprintf(stderr, "Compile failure in %s shader:\n%s\n",
-                string_shader_type, info_log);
-        
-        delete(info_log);
-    }
-    return shader;
-}
-
-GLuint
-sgl_internal_program_create(GLuint* shader_list, int size, char* debug_name)
-{
-    GLuint program = glCreateProgram();
-    
-    for(size_t index = 0; index < size; ++index)
-    {
-        glAttachShader(program, shader_list[index]);
-    }
-    glLinkProgram(program);
-
-    GLint status;
-    glGetProgramiv (program, GL_LINK_STATUS, &status);
-    if (status == GL_FALSE)
-    {
-        GLint info_log_length;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &info_log_length);
-
-        GLchar *string_info_log = new GLchar[info_log_length + 1];
-        glGetProgramInfoLog(program, info_log_length, NULL, string_info_log);
-            
-        fprintf(stderr, "Linker failure in Program [%s]: %s\n",debug_name,  string_info_log);
-
-        delete(string_info_log);
-    }
-    for(size_t index = 0; index < size; ++index)
-    {
-        glDetachShader(program, shader_list[index]);
-    }
-    return program;
-}
-
 internal void sgl_init_default_program()
 {
     const int32 shader_list_size = 2;
@@ -812,7 +7288,6 @@ internal void sgl_init_default_program()
 void sgl_init_default_state()
 {
     //Init default buffers
-    glGenBuffers(1, &sgl_default_ogl.index_buffer);
     //InitVertexBuffer(&sgl_default_ogl.VertexBuffer,triangle_vertex_positions,ArrayCount(triangle_vertex_positions));    
     //
 
@@ -824,6 +7299,8 @@ void sgl_init_default_state()
                  size,
                  triangle_vertex_positions,
                  GL_STATIC_DRAW);    
+    SGL_GPU_TRACK(SGL_GPU_BUFFER, sgl_default_ogl.vertex_buffer, size, 0, "SGL Default Triangle");
+    sgl_debug_label(GL_BUFFER, sgl_default_ogl.vertex_buffer, "SGL Default Triangle");
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
     sgl_init_default_program();
@@ -841,6 +7318,12 @@ void sgl_init_default_state()
     glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
+void sgl_free_default_state()
+{
+    sgl_internal_buffer_delete(&sgl_default_ogl.vertex_buffer);
+    sgl_internal_program_delete(&sgl_default_ogl.program_default);
+}
+
 void sgl_default_render(SGLWindow* window)
 {    
     glClearColor(1.0f, 0.5f, 0.5f, 1.0f);
@@ -868,6 +7351,8 @@ void sgl_default_render(SGLWindow* window)
    #error No other OS defined!
 #endif //_WIN32 
 
+    sgl_debug_frame_advance();
+
 }
 
 #endif // SGL_DEFAULT_EXAMPLE